@@ -0,0 +1,43 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <cstddef>
+#include <vector>
+
+
+// Non-owning view over contiguous elements, a minimal std::span for C++17
+template <typename T>
+class Span
+{
+public:
+    Span() : m_data(nullptr), m_size(0) {}
+    Span(T* data, const size_t& size) : m_data(data), m_size(size) {}
+    Span(T& element) : m_data(&element), m_size(1) {}
+
+    template <typename U>
+    Span(std::vector<U>& vector) : m_data(vector.data()), m_size(vector.size()) {}
+    template <typename U>
+    Span(const std::vector<U>& vector) : m_data(vector.data()), m_size(vector.size()) {}
+
+    // Span<T> converts to Span<const T>
+    template <typename U>
+    Span(const Span<U>& other) : m_data(other.data()), m_size(other.size()) {}
+
+    inline T* data() const { return m_data; }
+    inline size_t size() const { return m_size; }
+    inline bool empty() const { return m_size == 0; }
+
+    inline T& operator[](const size_t& index) const { return m_data[index]; }
+
+    inline T* begin() const { return m_data; }
+    inline T* end() const { return m_data + m_size; }
+
+    inline Span<T> subspan(const size_t& offset, const size_t& count) const { return Span<T>(m_data + offset, count); }
+
+private:
+    T* m_data;
+    size_t m_size;
+};
+
+
+#endif // SPAN_H
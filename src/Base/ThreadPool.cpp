@@ -0,0 +1,206 @@
+#include "ThreadPool.h"
+
+#include "Logging.h"
+
+#include <algorithm>
+#include <chrono>
+
+
+ThreadPool* ThreadPool::s_instance = nullptr;
+
+// Pool the calling thread is a worker of, and the index of its queue
+static thread_local const ThreadPool* currentPool = nullptr;
+static thread_local size_t currentQueueIndex = 0;
+
+
+ThreadPool& ThreadPool::Init(const size_t& threadCount)
+{
+    if (s_instance) {
+        LOG_WARNING("ThreadPool already exists, cannot Init() it twice.");
+        return *s_instance;
+    }
+
+    const size_t coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+    s_instance = new ThreadPool(threadCount ? threadCount : coreCount - 1);
+    return *s_instance;
+}
+
+void ThreadPool::Shutdown()
+{
+    delete s_instance;
+    s_instance = nullptr;
+}
+
+ThreadPool::ThreadPool(const size_t& threadCount)
+{
+    // The last queue is the one of the threads that aren't workers
+    for (size_t i=0 ; i <= threadCount ; ++i)
+        m_queues.push_back(std::make_unique<Queue>());
+
+    for (size_t i=0 ; i < threadCount ; ++i)
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wakeUp.notify_all();
+
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+void ThreadPool::Submit(Task task)
+{
+    // Counted first, under the sleep mutex, so that a worker about to sleep can't miss it
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        ++m_queuedCount;
+    }
+
+    Queue& queue = *m_queues[GetQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    m_wakeUp.notify_one();
+}
+
+bool ThreadPool::RunPending()
+{
+    const size_t queueIndex = GetQueueIndex();
+
+    Task task;
+    if (!Pop(queueIndex, task) && !Steal(queueIndex, task))
+        return false;
+
+    task();
+    return true;
+}
+
+size_t ThreadPool::GetQueueIndex() const
+{
+    return currentPool == this ? currentQueueIndex : m_workers.size();
+}
+
+bool ThreadPool::Pop(const size_t& queueIndex, Task& task)
+{
+    Queue& queue = *m_queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+        return false;
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    --m_queuedCount;
+    return true;
+}
+
+bool ThreadPool::Steal(const size_t& queueIndex, Task& task)
+{
+    for (size_t i=1 ; i < m_queues.size() ; ++i)
+    {
+        Queue& queue = *m_queues[(queueIndex + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        --m_queuedCount;
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::WorkerLoop(const size_t& queueIndex)
+{
+    currentPool = this;
+    currentQueueIndex = queueIndex;
+
+    while (true)
+    {
+        Task task;
+        if (Pop(queueIndex, task) || Steal(queueIndex, task))
+        {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wakeUp.wait(lock, [this]() { return m_stopping || m_queuedCount > 0; });
+        if (m_stopping && m_queuedCount == 0)
+            return;
+    }
+}
+
+
+// == TaskGroup ==
+
+void TaskGroup::Run(Task task)
+{
+    ++m_remaining;
+    m_pool.Submit([this, task=std::move(task)]()
+    {
+        task();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_remaining == 0)
+            m_done.notify_all();
+    });
+}
+
+// Runs the queued tasks while there are, then spins for a while before sleeping until the tasks
+// run by the other threads are done. Sleeps are short, tasks queued in the meantime are run as well.
+void TaskGroup::Wait()
+{
+    constexpr size_t spinCount = 64;
+    constexpr auto sleepDuration = std::chrono::milliseconds(1);
+
+    size_t spins = 0;
+    while (m_remaining > 0)
+    {
+        if (m_pool.RunPending())
+            spins = 0;
+        else if (++spins < spinCount)
+            std::this_thread::yield();
+        else
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait_for(lock, sleepDuration, [this]() { return m_remaining == 0; });
+        }
+    }
+
+    // The last task releases the mutex after decrementing, taking it makes sure it is done with the group
+    std::lock_guard<std::mutex> lock(m_mutex);
+}
+
+
+// == ParallelFor ==
+
+void ParallelFor(const size_t& count, const size_t& grainSize, const std::function<void(size_t, size_t)>& function)
+{
+    constexpr size_t chunksPerThread = 4;
+    const size_t threadCount = ThreadPool::IsInitialized() ? ThreadPool::Get().GetThreadCount() + 1 : 1;
+    const size_t chunkCount = chunksPerThread * threadCount;
+    const size_t chunkSize = std::max(std::max(grainSize, (size_t)1), (count + chunkCount - 1) / chunkCount);
+    if (threadCount == 1 || count <= chunkSize)
+    {
+        if (count)
+            function(0, count);
+        return;
+    }
+
+    TaskGroup group(ThreadPool::Get());
+    for (size_t begin=chunkSize ; begin < count ; begin += chunkSize)
+    {
+        const size_t end = std::min(begin + chunkSize, count);
+        group.Run([&function, begin, end]() { function(begin, end); });
+    }
+
+    function(0, chunkSize);
+    group.Wait();
+}
@@ -0,0 +1,98 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+using Task = std::function<void()>;
+
+
+// Worker threads sharing tasks by work stealing : each worker has its own queue, runs the
+// tasks it queued itself last in first out, and steals the oldest tasks of the other queues
+// once its own is empty. Tasks queued from other threads go to a queue of their own.
+class ThreadPool
+{
+public:
+    // Creates the shared pool, a threadCount of 0 using one worker per core besides the calling thread
+    static ThreadPool& Init(const size_t& threadCount=0);
+    inline static ThreadPool& Get() { return *s_instance; }
+    inline static bool IsInitialized() { return s_instance != nullptr; }
+    // Joins the workers of the shared pool and destroys it, before the program exits
+    static void Shutdown();
+
+    explicit ThreadPool(const size_t& threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    inline size_t GetThreadCount() const { return m_workers.size(); }
+
+    void Submit(Task task);
+    // Runs a queued task on the calling thread, returns false when there was none
+    bool RunPending();
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Queue of the calling thread, the shared one for the threads that aren't workers of this pool
+    size_t GetQueueIndex() const;
+    bool Pop(const size_t& queueIndex, Task& task);
+    bool Steal(const size_t& queueIndex, Task& task);
+    void WorkerLoop(const size_t& queueIndex);
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    // Workers sleep while no task is queued
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeUp;
+    std::atomic<size_t> m_queuedCount{0};
+    bool m_stopping = false;
+
+    static ThreadPool* s_instance;
+};
+
+
+// Tasks that are waited for together. The waiting thread runs queued tasks in the meantime,
+// so tasks of a group can themselves run and wait for other groups.
+class TaskGroup
+{
+public:
+    TaskGroup(ThreadPool& pool) : m_pool(pool) {}
+    ~TaskGroup() { Wait(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void Run(Task task);
+    void Wait();
+
+private:
+    ThreadPool& m_pool;
+    std::atomic<size_t> m_remaining{0};
+
+    // Signaled when the last task is done, for the waiting thread once there is nothing left to run
+    std::mutex m_mutex;
+    std::condition_variable m_done;
+};
+
+
+// Calls function(begin, end) over chunks of [0, count), on the shared pool when it exists, the calling
+// thread processing the first chunk. Chunks hold at least grainSize indices, with a few chunks per thread
+// so that stealing evens out their costs. Runs everything on the calling thread when there is a single chunk.
+void ParallelFor(const size_t& count, const size_t& grainSize, const std::function<void(size_t, size_t)>& function);
+
+
+#endif  // THREADPOOL_H
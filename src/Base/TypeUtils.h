@@ -2,6 +2,9 @@
 #define TYPEUTILS_H
 
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
 
 // From boost::hash_combine
 template <class T>
@@ -11,5 +14,15 @@ void HashCombine(size_t& seed, const T& value)
   seed ^= hash(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
 
+// Appends the bits of value to key, two keys only being equal when all of their values are
+template <class T>
+void AppendKey(std::vector<uint64_t>& key, const T& value)
+{
+  static_assert(sizeof(T) <= sizeof(uint64_t), "AppendKey only takes values of up to 64 bits");
+  uint64_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(T));
+  key.push_back(bits);
+}
+
 
 #endif // TYPEUTILS_H
@@ -0,0 +1,561 @@
+#include "C3GABatch.hpp"
+
+#include "C3GABatchKernels.hpp"
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+
+namespace c3ga {
+
+
+namespace detail {
+
+// Defined in C3GABatchAvx2.cpp and C3GABatchAvx512.cpp, return nullptr when not built
+const BatchKernel* getAvx2BatchKernels();
+const BatchKernel* getAvx512BatchKernels();
+
+static const BatchKernel* getScalarBatchKernels()
+{
+    static constexpr auto kernels = makeBatchKernels<ScalarLanes>(std::make_index_sequence<216>{});
+    return kernels.data();
+}
+
+static SimdLevel detectSimdLevel()
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && getAvx512BatchKernels())
+        return SimdLevel::Avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && getAvx2BatchKernels())
+        return SimdLevel::Avx2;
+#endif
+
+    return SimdLevel::Scalar;
+}
+
+static const BatchKernel* getBatchKernels()
+{
+    static const BatchKernel* kernels = []() {
+        switch (getSimdLevel())
+        {
+            case SimdLevel::Avx512: return getAvx512BatchKernels();
+            case SimdLevel::Avx2: return getAvx2BatchKernels();
+            default: return getScalarBatchKernels();
+        }
+    }();
+
+    return kernels;
+}
+
+} // namespace detail
+
+
+SimdLevel getSimdLevel()
+{
+    static const SimdLevel level = detail::detectSimdLevel();
+    return level;
+}
+
+const char* simdLevelName(const SimdLevel& level)
+{
+    switch (level)
+    {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::Avx2: return "AVX2";
+        case SimdLevel::Avx512: return "AVX-512";
+    }
+
+    return "Unknown";
+}
+
+BatchKernel getBatchKernel(const unsigned int& lhsGrade,
+                           const unsigned int& rhsGrade,
+                           const unsigned int& resultGrade)
+{
+    return detail::getBatchKernels()[lhsGrade * 36 + rhsGrade * 6 + resultGrade];
+}
+
+
+// Accumulates <product>(lhs, rhs) for each of the <grades> of the result.
+// lhs and rhs are single grade blocks, result is a full structure of arrays.
+static void accumulateBatchProduct(const Product& product,
+                                   const unsigned int& lhsGrade, const double* lhs, const size_t& lhsStride,
+                                   const unsigned int& rhsGrade, const double* rhs, const size_t& rhsStride,
+                                   double* result, const size_t& count)
+{
+    const uint32_t grades = productGrades(product, lhsGrade, rhsGrade);
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+    {
+        if (!(grades & (1 << grade)))
+            continue;
+
+        if (auto kernel = getBatchKernel(lhsGrade, rhsGrade, grade))
+            kernel(lhs, lhsStride,
+                   rhs, rhsStride,
+                   result + perGradeStartingIndex[grade] * count, count,
+                   count);
+    }
+}
+
+// Grades of <product>(mv, trailing) for mv of the given grades
+static uint32_t trailingProductGrades(const Product& product, const uint32_t& grades, const DenseMvec<double>& trailing)
+{
+    uint32_t result = 0;
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+        if (grades & (1 << grade))
+            for (unsigned int trailingGrade=0 ; trailingGrade <= algebraDimension ; ++trailingGrade)
+                if (trailing.isGrade(trailingGrade))
+                    result |= productGrades(product, grade, trailingGrade);
+
+    return result;
+}
+
+// Accumulates <product>(columns, trailing) into result, both full structures of arrays
+static void accumulateTrailingProduct(const Product& product, const uint32_t& grades, const double* columns,
+                                      const DenseMvec<double>& trailing, double* result, const size_t& count)
+{
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+    {
+        if (!(grades & (1 << grade)))
+            continue;
+
+        for (unsigned int trailingGrade=0 ; trailingGrade <= algebraDimension ; ++trailingGrade)
+            if (trailing.isGrade(trailingGrade))
+                accumulateBatchProduct(product,
+                                       grade, columns + perGradeStartingIndex[grade] * count, count,
+                                       trailingGrade, trailing.gradeData(trailingGrade), 0,
+                                       result, count);
+    }
+}
+
+// pairwiseProduct() with the kernels : each lhs object is broadcast against the lanes of all the rhs objects
+static void kernelPairwiseProduct(const Product& product,
+                                  const unsigned int& lhsGrade, const double* lhsColumns, const size_t& lhsCount,
+                                  const unsigned int& rhsGrade, const double* rhsColumns, const size_t& count,
+                                  const DenseMvec<double>* trailing,
+                                  DenseMvec<double>* result)
+{
+    const uint32_t grades = productGrades(product, lhsGrade, rhsGrade);
+    const uint32_t trailingGrades = trailing ? trailingProductGrades(product, grades, *trailing) : 0;
+
+    // The outer product keeps the blocks it writes, even zero ones, like garamon does
+    const bool keepZeroBlocks = product == Product::Outer;
+
+    double lhsBlock[10];
+    std::vector<double> columns(denseSize * count);
+    std::vector<double> trailingColumns(trailing ? denseSize * count : 0);
+    for (size_t i=0 ; i < lhsCount ; ++i)
+    {
+        for (unsigned int c=0 ; c < binomialArray[lhsGrade] ; ++c)
+            lhsBlock[c] = lhsColumns[c * lhsCount + i];
+
+        std::fill(columns.begin(), columns.end(), 0.0);
+        accumulateBatchProduct(product,
+                               lhsGrade, lhsBlock, 0,
+                               rhsGrade, rhsColumns, count,
+                               columns.data(), count);
+
+        if (!trailing)
+        {
+            scatterGrades(columns.data(), count, grades, keepZeroBlocks, result + i * count);
+            continue;
+        }
+
+        std::fill(trailingColumns.begin(), trailingColumns.end(), 0.0);
+        accumulateTrailingProduct(product, grades, columns.data(), *trailing, trailingColumns.data(), count);
+        scatterGrades(trailingColumns.data(), count, trailingGrades, keepZeroBlocks, result + i * count);
+    }
+}
+
+// pairwiseProduct() with matrix products : each object of the smaller operand defines a linear map
+// on the blocks of the other one, L_b(x) = <product>(x, b). The matrices of these maps are stacked
+// and applied to the blocks of all the other objects at once, by chunks.
+static void bilinearPairwiseProduct(const Product& product,
+                                    const unsigned int& lhsGrade, const double* lhsColumns, const size_t& lhsCount,
+                                    const unsigned int& rhsGrade, const double* rhsColumns, const size_t& rhsCount,
+                                    const DenseMvec<double>* trailing,
+                                    DenseMvec<double>* result)
+{
+    using RowMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    const bool fixedRhs = rhsCount <= lhsCount;
+    const unsigned int fixedGrade = fixedRhs ? rhsGrade : lhsGrade;
+    const double* fixedColumns = fixedRhs ? rhsColumns : lhsColumns;
+    const size_t fixedCount = fixedRhs ? rhsCount : lhsCount;
+    const unsigned int freeGrade = fixedRhs ? lhsGrade : rhsGrade;
+    const double* freeColumns = fixedRhs ? lhsColumns : rhsColumns;
+    const size_t freeCount = fixedRhs ? lhsCount : rhsCount;
+
+    const uint32_t firstGrades = productGrades(product, lhsGrade, rhsGrade);
+    const uint32_t grades = trailing ? trailingProductGrades(product, firstGrades, *trailing) : firstGrades;
+    const bool keepZeroBlocks = product == Product::Outer;
+
+    // Rows of the maps, the coefficients of the result grades
+    unsigned int rows[denseSize];
+    unsigned int rowCount = 0;
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+        if (grades & (1 << grade))
+            for (unsigned int c=0 ; c < binomialArray[grade] ; ++c)
+                rows[rowCount++] = perGradeStartingIndex[grade] + c;
+
+    // The matrix of each map is its image of the basis blades of the free grade, one per lane
+    const size_t laneCount = binomialArray[freeGrade];
+    std::vector<double> basis(laneCount * laneCount, 0.0);
+    for (size_t c=0 ; c < laneCount ; ++c)
+        basis[c * laneCount + c] = 1.0;
+
+    RowMatrix maps(fixedCount * rowCount, laneCount);
+    double fixedBlock[10];
+    std::vector<double> columns(denseSize * laneCount);
+    std::vector<double> trailingColumns(trailing ? denseSize * laneCount : 0);
+    for (size_t f=0 ; f < fixedCount ; ++f)
+    {
+        for (unsigned int c=0 ; c < binomialArray[fixedGrade] ; ++c)
+            fixedBlock[c] = fixedColumns[c * fixedCount + f];
+
+        std::fill(columns.begin(), columns.end(), 0.0);
+        if (fixedRhs)
+            accumulateBatchProduct(product, lhsGrade, basis.data(), laneCount, rhsGrade, fixedBlock, 0, columns.data(), laneCount);
+        else
+            accumulateBatchProduct(product, lhsGrade, fixedBlock, 0, rhsGrade, basis.data(), laneCount, columns.data(), laneCount);
+
+        const double* mapColumns = columns.data();
+        if (trailing)
+        {
+            std::fill(trailingColumns.begin(), trailingColumns.end(), 0.0);
+            accumulateTrailingProduct(product, firstGrades, columns.data(), *trailing, trailingColumns.data(), laneCount);
+            mapColumns = trailingColumns.data();
+        }
+
+        for (unsigned int r=0 ; r < rowCount ; ++r)
+            for (size_t c=0 ; c < laneCount ; ++c)
+                maps(f * rowCount + r, c) = mapColumns[rows[r] * laneCount + c];
+    }
+
+    // Each column of the products holds the result blocks of one free object with all the fixed ones,
+    // the chunks are kept small enough for the products to stay in cache until they are scattered
+    const size_t chunkSize = std::max((size_t)1, ((size_t)1 << 16) / std::max((size_t)1, fixedCount * rowCount));
+    const Eigen::Map<const RowMatrix> freeBlocks(freeColumns, laneCount, freeCount);
+    Eigen::MatrixXd products;
+    for (size_t start=0 ; start < freeCount ; start += chunkSize)
+    {
+        const size_t size = std::min(chunkSize, freeCount - start);
+        products.noalias() = maps * freeBlocks.middleCols(start, size);
+
+        for (size_t c=0 ; c < size ; ++c)
+        {
+            const size_t n = start + c;
+            for (size_t f=0 ; f < fixedCount ; ++f)
+            {
+                DenseMvec<double>& object = result[fixedRhs ? n * fixedCount + f : f * freeCount + n];
+                object.clear();
+
+                const double* values = products.data() + c * products.rows() + f * rowCount;
+                uint32_t bitmap = 0;
+                unsigned int r = 0;
+                for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+                {
+                    if (!(grades & (1 << grade)))
+                        continue;
+
+                    bool isZero = true;
+                    for (unsigned int i=0 ; i < binomialArray[grade] ; ++i, ++r)
+                    {
+                        object.data()[rows[r]] = values[r];
+                        isZero &= values[r] == 0.0;
+                    }
+
+                    if (keepZeroBlocks || !isZero)
+                        bitmap |= 1 << grade;
+                }
+                object.setGradeBitmap(bitmap);
+            }
+        }
+    }
+}
+
+// pairwiseProduct() for objects already gathered into the columns of their grade
+static void pairwiseColumnsProduct(const Product& product,
+                                   const unsigned int& lhsGrade, const double* lhsColumns, const size_t& lhsCount,
+                                   const unsigned int& rhsGrade, const double* rhsColumns, const size_t& rhsCount,
+                                   const DenseMvec<double>* trailing,
+                                   DenseMvec<double>* result)
+{
+    // The kernels leave most lanes idle when one of the operands only has a few objects, and
+    // inner products of vectors are a single matrix product of their coefficients
+    constexpr size_t bilinearMaxCount = 64;
+    const bool vectorInnerProduct = product == Product::Inner && lhsGrade == 1 && rhsGrade == 1;
+    if (std::min(lhsCount, rhsCount) <= bilinearMaxCount || vectorInnerProduct)
+        bilinearPairwiseProduct(product, lhsGrade, lhsColumns, lhsCount, rhsGrade, rhsColumns, rhsCount, trailing, result);
+    else
+        kernelPairwiseProduct(product, lhsGrade, lhsColumns, lhsCount, rhsGrade, rhsColumns, rhsCount, trailing, result);
+}
+
+bool pairwiseProduct(const Product& product,
+                     const DenseMvec<double>* lhs, const size_t& lhsCount,
+                     const DenseMvec<double>* rhs, const size_t& rhsCount,
+                     const DenseMvec<double>* trailing,
+                     DenseMvec<double>* result)
+{
+    const int lhsGrade = commonGrade(lhs, lhsCount);
+    const int rhsGrade = commonGrade(rhs, rhsCount);
+    if (lhsGrade < 0 || rhsGrade < 0)
+        return false;
+
+    std::vector<double> lhsColumns(binomialArray[lhsGrade] * lhsCount);
+    gatherGrade(lhs, lhsCount, lhsGrade, lhsColumns.data());
+    std::vector<double> rhsColumns(binomialArray[rhsGrade] * rhsCount);
+    gatherGrade(rhs, rhsCount, rhsGrade, rhsColumns.data());
+
+    pairwiseColumnsProduct(product, lhsGrade, lhsColumns.data(), lhsCount, rhsGrade, rhsColumns.data(), rhsCount, trailing, result);
+    return true;
+}
+
+bool pairwiseProduct(const Product& product,
+                     const DenseMvec<double>* lhs, const size_t& lhsCount,
+                     const PackedArray<double>& rhs,
+                     const DenseMvec<double>* trailing,
+                     DenseMvec<double>* result)
+{
+    const int lhsGrade = commonGrade(lhs, lhsCount);
+    if (lhsGrade < 0 || rhs.empty())
+        return false;
+
+    std::vector<double> lhsColumns(binomialArray[lhsGrade] * lhsCount);
+    gatherGrade(lhs, lhsCount, lhsGrade, lhsColumns.data());
+
+    pairwiseColumnsProduct(product, lhsGrade, lhsColumns.data(), lhsCount, rhs.grade(), rhs.data(), rhs.size(), trailing, result);
+    return true;
+}
+
+void gatherBlocks(const DenseMvec<double>* objects, const uint32_t* indices, const size_t& indexStride,
+                  const size_t& count, const unsigned int& grade, const bool& dual, double* columns)
+{
+    const unsigned int start = perGradeStartingIndex[grade];
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        const double* coeffs = objects[indices ? indices[n * indexStride] : n].data();
+        for (unsigned int c=0 ; c < binomialArray[grade] ; ++c)
+            columns[c * count + n] = dual ? denseDualSigns[start + c] * coeffs[denseDualSources[start + c]] : coeffs[start + c];
+    }
+}
+
+void gatherBlocks(const PackedArray<double>& objects, const uint32_t* indices, const size_t& indexStride,
+                  const size_t& count, const unsigned int& grade, const bool& dual, double* columns)
+{
+    const unsigned int start = perGradeStartingIndex[grade];
+    const unsigned int sourceStart = perGradeStartingIndex[objects.grade()];
+    for (unsigned int c=0 ; c < binomialArray[grade] ; ++c)
+    {
+        const double* source = objects.column(dual ? denseDualSources[start + c] - sourceStart : c);
+        const double sign = dual ? denseDualSigns[start + c] : 1.0;
+        double* column = columns + c * count;
+        for (size_t n=0 ; n < count ; ++n)
+            column[n] = sign * source[indices ? indices[n * indexStride] : n];
+    }
+}
+
+
+// Vectors <start, count> of objects as columns of a matrix, normalized by their e0 coefficient
+static Eigen::MatrixXd normalizedVectors(const PackedArray<double>& objects, const size_t& start, const size_t& count)
+{
+    const unsigned int e0Row = xorIndexToDenseIndex[E0] - perGradeStartingIndex[1];
+
+    Eigen::MatrixXd result = Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+            objects.data(), binomialArray[1], objects.size()).middleCols(start, count);
+    for (size_t n=0 ; n < count ; ++n)
+        if (result(e0Row, n) != 0.0)
+            result.col(n) /= result(e0Row, n);
+
+    return result;
+}
+
+void vectorPowers(const PackedArray<double>& lhs, const size_t& lhsStart, const size_t& lhsCount,
+                  const PackedArray<double>& rhs, const size_t& rhsStart, const size_t& rhsCount,
+                  double* result)
+{
+    // -2 times the metric of the vectors, e1, e2, e3 squaring to 1 and e0 | ei = -1
+    const unsigned int e0Row = xorIndexToDenseIndex[E0] - perGradeStartingIndex[1];
+    const unsigned int eiRow = xorIndexToDenseIndex[Ei] - perGradeStartingIndex[1];
+    Eigen::Matrix<double, 5, 5> metric = Eigen::Matrix<double, 5, 5>::Identity() * -2.0;
+    metric(e0Row, e0Row) = metric(eiRow, eiRow) = 0.0;
+    metric(e0Row, eiRow) = metric(eiRow, e0Row) = 2.0;
+
+    const Eigen::MatrixXd lhsVectors = normalizedVectors(lhs, lhsStart, lhsCount);
+    const Eigen::MatrixXd rhsVectors = metric * normalizedVectors(rhs, rhsStart, rhsCount);
+
+    Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(result, lhsCount, rhsCount).noalias() =
+            lhsVectors.transpose() * rhsVectors;
+}
+
+bool elementwiseProduct(const Product& product,
+                        const DenseMvec<double>* lhs,
+                        const DenseMvec<double>* rhs,
+                        const size_t& count,
+                        const bool& broadcastRhs,
+                        DenseMvec<double>* result)
+{
+    const int lhsGrade = commonGrade(lhs, count);
+    const int rhsGrade = broadcastRhs ? 0 : commonGrade(rhs, count);
+    if (lhsGrade < 0 || rhsGrade < 0)
+        return false;
+
+    std::vector<double> lhsColumns(binomialArray[lhsGrade] * count);
+    gatherGrade(lhs, count, lhsGrade, lhsColumns.data());
+
+    std::vector<double> columns(denseSize * count, 0.0);
+    uint32_t grades = 0;
+    if (broadcastRhs)
+    {
+        for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+        {
+            if (!rhs->isGrade(grade))
+                continue;
+
+            accumulateBatchProduct(product,
+                                   lhsGrade, lhsColumns.data(), count,
+                                   grade, rhs->gradeData(grade), 0,
+                                   columns.data(), count);
+            grades |= productGrades(product, lhsGrade, grade);
+        }
+    }
+    else
+    {
+        std::vector<double> rhsColumns(binomialArray[rhsGrade] * count);
+        gatherGrade(rhs, count, rhsGrade, rhsColumns.data());
+
+        accumulateBatchProduct(product,
+                               lhsGrade, lhsColumns.data(), count,
+                               rhsGrade, rhsColumns.data(), count,
+                               columns.data(), count);
+        grades = productGrades(product, lhsGrade, rhsGrade);
+    }
+
+    scatterGrades(columns.data(), count, grades, product == Product::Outer, result);
+    return true;
+}
+
+
+
+// == Epilogues ==
+
+namespace {
+
+// Coefficients the weight of the objects of a grade is read from, as indices in the objects
+struct WeightBlades
+{
+    // e0 coefficient of the extracted vector and its sign, for grades 1 and 4
+    bool isVector = false;
+    unsigned int e0 = 0;
+    double e0Sign = 1.0;
+    // Blades holding e0, and the Euclidean ones
+    unsigned int roundCount = 0;
+    unsigned int round[10] = {};
+    unsigned int flatCount = 0;
+    unsigned int flat[10] = {};
+};
+
+constexpr auto weightBlades = []() {
+    std::array<WeightBlades, algebraDimension + 1> result{};
+    for (unsigned int grade=1 ; grade < algebraDimension ; ++grade)
+    {
+        WeightBlades& blades = result[grade];
+        const unsigned int extractedGrade = grade <= 2 ? grade : algebraDimension - grade;
+        blades.isVector = extractedGrade == 1;
+        for (unsigned int c=0 ; c < binomialArray[extractedGrade] ; ++c)
+        {
+            const unsigned int extracted = perGradeStartingIndex[extractedGrade] + c;
+            const unsigned int source = grade <= 2 ? extracted : denseDualSources[extracted];
+            const unsigned int xorIndex = denseIndexToXorIndex[extracted];
+            if (xorIndex == E0)
+            {
+                blades.e0 = source;
+                blades.e0Sign = grade <= 2 ? 1.0 : denseDualSigns[extracted];
+            }
+
+            if (xorIndex & E0)
+                blades.round[blades.roundCount++] = source;
+            else if (!(xorIndex & Ei))
+                blades.flat[blades.flatCount++] = source;
+        }
+    }
+    return result;
+}();
+
+double objectWeight(const DenseMvec<double>& object, const WeightBlades& blades)
+{
+    const double* coeffs = object.data();
+    if (blades.isVector && coeffs[blades.e0] != 0.0)
+        return blades.e0Sign * coeffs[blades.e0];
+
+    double round = 0.0;
+    for (unsigned int i=0 ; i < blades.roundCount ; ++i)
+        round += coeffs[blades.round[i]] * coeffs[blades.round[i]];
+    if (round > 0.0)
+        return std::sqrt(round);
+
+    double flat = 0.0;
+    for (unsigned int i=0 ; i < blades.flatCount ; ++i)
+        flat += coeffs[blades.flat[i]] * coeffs[blades.flat[i]];
+    return std::sqrt(flat);
+}
+
+} // namespace
+
+bool applyEpilogue(const uint32_t& epilogue, const double& roundEpsilon,
+                   DenseMvec<double>* objects, const size_t& count)
+{
+    const bool normalize = epilogue & Epilogue_Normalize;
+    const bool roundZero = epilogue & Epilogue_RoundZero;
+
+    bool droppedBlocks = false;
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        DenseMvec<double>& object = objects[n];
+        if (object.isEmpty())
+            continue;
+
+        const uint32_t bitmap = object.gradeBitmap();
+        const unsigned int grade = object.grade();
+        double scale = 1.0;
+        if (normalize && object.isHomogeneous() && grade > 0 && grade < algebraDimension)
+        {
+            const double weight = objectWeight(object, weightBlades[grade]);
+            if (weight != 0.0)
+                scale = 1.0 / weight;
+        }
+
+        // Only the blocks of the object are touched, the others are zero already
+        uint32_t roundedBitmap = 0;
+        for (unsigned int g=0 ; g <= algebraDimension ; ++g)
+        {
+            if (!(bitmap & (1 << g)))
+                continue;
+
+            double* block = object.gradeData(g);
+            bool isZero = true;
+            for (unsigned int c=0 ; c < binomialArray[g] ; ++c)
+            {
+                block[c] *= scale;
+                if (roundZero && std::abs(block[c]) <= roundEpsilon)
+                    block[c] = 0.0;
+                isZero &= block[c] == 0.0;
+            }
+
+            if (!roundZero || !isZero)
+                roundedBitmap |= 1 << g;
+        }
+
+        if (roundedBitmap != bitmap)
+        {
+            object.setGradeBitmap(roundedBitmap);
+            droppedBlocks = true;
+        }
+    }
+
+    return droppedBlocks;
+}
+
+
+} // namespace c3ga
@@ -0,0 +1,391 @@
+#ifndef C3GABATCH_HPP
+#define C3GABATCH_HPP
+
+#include "C3GAProducts.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace c3ga {
+
+
+// Products of many pairs of same-grade multivectors at once.
+// Operands are stored as structure of arrays : the coefficient c of a grade block of the
+// lane n is at block[c * stride + n], so that one SIMD lane processes one pair of objects.
+// A stride of 0 broadcasts a single block (coefficient c at block[c]) to every lane.
+
+enum class SimdLevel
+{
+    Scalar,
+    Avx2,
+    Avx512
+};
+
+// Instruction set picked at startup for the batched kernels
+SimdLevel getSimdLevel();
+const char* simdLevelName(const SimdLevel& level);
+
+// Accumulates the grade <resultGrade> part of lhs * rhs into result for <count> lanes.
+// The result must not alias one of the operands.
+using BatchKernel = void(*)(const double* lhs, size_t lhsStride,
+                            const double* rhs, size_t rhsStride,
+                            double* result, size_t resultStride,
+                            size_t count);
+
+// Returns nullptr for the triples whose product is always zero
+BatchKernel getBatchKernel(const unsigned int& lhsGrade,
+                           const unsigned int& rhsGrade,
+                           const unsigned int& resultGrade);
+
+// Computes <product>(lhs[i], rhs[j]) for every pair and stores it in result[i * rhsCount + j],
+// with the same grade semantics as the DenseMvec operators. If trailing is not null, each
+// product is then multiplied by it, the same way : <product>(<product>(lhs[i], rhs[j]), *trailing).
+// When one of the arrays only holds a few objects, or for inner products of vectors, each of its objects
+// is turned into the matrix of its product with the other array, all the pairs being evaluated as matrix products.
+// Only works when each array holds objects of a single grade : returns false otherwise
+// and leaves result untouched.
+bool pairwiseProduct(const Product& product,
+                     const DenseMvec<double>* lhs, const size_t& lhsCount,
+                     const DenseMvec<double>* rhs, const size_t& rhsCount,
+                     const DenseMvec<double>* trailing,
+                     DenseMvec<double>* result);
+
+// Computes <product>(lhs[n], rhs[n]) into result[n] for every n < count. If broadcastRhs is set,
+// rhs holds a single object used for every n, which may have several grades.
+// The result may alias one of the operands.
+// Only works when the objects of each array have a single grade : returns false otherwise
+// and leaves result untouched.
+bool elementwiseProduct(const Product& product,
+                        const DenseMvec<double>* lhs,
+                        const DenseMvec<double>* rhs,
+                        const size_t& count,
+                        const bool& broadcastRhs,
+                        DenseMvec<double>* result);
+
+
+// == Epilogues ==
+
+// Passes the providers can fuse over the objects they just computed
+enum EpilogueBits
+{
+    Epilogue_None = 0,
+    // Scales each object so that its weight is 1, like the extractors do before reading it.
+    // The weight is read from the form the objects are extracted from, the dual for grades 3 and 4 :
+    // the e0 coefficient for points and dual spheres, the norm of the blades holding e0 for the
+    // other round objects, and the norm of the Euclidean blades for flat ones.
+    Epilogue_Normalize = 1 << 0,
+    // Same as DenseMvec::roundZero on each object
+    Epilogue_RoundZero = 1 << 1,
+};
+
+// Runs the passes of <epilogue> over count objects, in a single pass over each of them.
+// Non homogeneous objects and the ones of null weight aren't normalized.
+// Returns whether rounding dropped a block from one of the objects, which may change its type.
+bool applyEpilogue(const uint32_t& epilogue, const double& roundEpsilon,
+                   DenseMvec<double>* objects, const size_t& count);
+
+
+// == Layout conversions ==
+
+// Returns the grade shared by all the objects, or -1 if they are empty or not all of a single grade
+template <typename T>
+int commonGrade(const DenseMvec<T>* objects, const size_t& count)
+{
+    if (count == 0)
+        return -1;
+
+    const uint32_t bitmap = objects[0].gradeBitmap();
+    if (bitmap == 0 || !objects[0].isHomogeneous())
+        return -1;
+
+    for (size_t i=1 ; i < count ; ++i)
+        if (objects[i].gradeBitmap() != bitmap)
+            return -1;
+
+    return objects[0].grade();
+}
+
+// Copies the grade <grade> block of each object into columns of <count> values
+template <typename T>
+void gatherGrade(const DenseMvec<T>* objects, const size_t& count, const unsigned int& grade, T* columns)
+{
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        const T* block = objects[n].gradeData(grade);
+        for (unsigned int c=0 ; c < binomialArray[grade] ; ++c)
+            columns[c * count + n] = block[c];
+    }
+}
+
+// Copies the blocks of <grades> from full (denseSize columns of <count> values) structure of arrays.
+// Unless keepZeroBlocks is set, the blocks that are zero are dropped from the grade bitmap of each object.
+template <typename T>
+void scatterGrades(const T* columns, const size_t& count, const uint32_t& grades,
+                   const bool& keepZeroBlocks, DenseMvec<T>* objects)
+{
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        DenseMvec<T>& object = objects[n];
+        object.clear();
+
+        uint32_t bitmap = 0;
+        for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+        {
+            if (!(grades & (1 << grade)))
+                continue;
+
+            T* block = object.gradeData(grade);
+            bool isZero = true;
+            for (unsigned int c=0 ; c < binomialArray[grade] ; ++c)
+            {
+                block[c] = columns[(perGradeStartingIndex[grade] + c) * count + n];
+                isZero &= block[c] == T(0);
+            }
+
+            if (keepZeroBlocks || !isZero)
+                bitmap |= 1 << grade;
+        }
+        object.setGradeBitmap(bitmap);
+    }
+}
+
+
+// == Packed storage ==
+
+// Objects sharing a single grade, stored as the structure of arrays of that grade's coefficients only :
+// coefficient c of the object n is at data()[c * size() + n], the layout the batch kernels work on.
+template <typename T>
+class PackedArray
+{
+public:
+    PackedArray() : m_grade(0), m_count(0) {}
+
+    inline unsigned int grade() const { return m_grade; }
+    inline size_t size() const { return m_count; }
+    inline bool empty() const { return m_count == 0; }
+
+    inline T* data() { return m_columns.data(); }
+    inline const T* data() const { return m_columns.data(); }
+    inline const T* column(const unsigned int& c) const { return m_columns.data() + c * m_count; }
+
+    // Sets the grade and count of the objects, their coefficients are left to be written
+    void resize(const unsigned int& grade, const size_t& count);
+
+    // Packs the objects if they all have the same single grade.
+    // Returns false and leaves the array untouched otherwise.
+    template <typename U>
+    bool pack(const DenseMvec<U>* objects, const size_t& count);
+
+    // Copies the object n into result, only writing its grade block when result already has that grade
+    template <typename U>
+    void get(const size_t& n, DenseMvec<U>& result) const;
+
+    // Overwrites the object n. Returns false and leaves the array untouched when object doesn't only have its grade.
+    template <typename U>
+    bool set(const size_t& n, const DenseMvec<U>& object);
+
+    // Same, appending object
+    template <typename U>
+    bool push_back(const DenseMvec<U>& object);
+
+    void erase(const size_t& n);
+
+    // Copies all the objects, objects must hold size() of them
+    template <typename U>
+    void unpack(DenseMvec<U>* objects) const;
+
+    // Copy converting the precision of the coefficients
+    template <typename U>
+    void assign(const PackedArray<U>& other);
+    // Same, only copying the objects [offset, offset + count) of other
+    template <typename U>
+    void assign(const PackedArray<U>& other, const size_t& offset, const size_t& count);
+
+    // Replaces each object by its dual, which only reorders the columns and changes their sign
+    void dualize();
+
+    void clear();
+
+private:
+    template <typename U>
+    friend class PackedArray;
+
+    unsigned int m_grade;
+    size_t m_count;
+    std::vector<T> m_columns;
+};
+
+template <typename T>
+template <typename U>
+bool PackedArray<T>::pack(const DenseMvec<U>* objects, const size_t& count)
+{
+    const int grade = commonGrade(objects, count);
+    if (grade < 0)
+        return false;
+
+    resize(grade, count);
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        const U* block = objects[n].gradeData(grade);
+        for (unsigned int c=0 ; c < binomialArray[grade] ; ++c)
+            m_columns[c * count + n] = T(block[c]);
+    }
+
+    return true;
+}
+
+template <typename T>
+template <typename U>
+void PackedArray<T>::get(const size_t& n, DenseMvec<U>& result) const
+{
+    const uint32_t bitmap = 1 << m_grade;
+    if (result.gradeBitmap() != bitmap)
+    {
+        result.clear();
+        result.setGradeBitmap(bitmap);
+    }
+
+    U* block = result.gradeData(m_grade);
+    for (unsigned int c=0 ; c < binomialArray[m_grade] ; ++c)
+        block[c] = U(m_columns[c * m_count + n]);
+}
+
+template <typename T>
+template <typename U>
+bool PackedArray<T>::set(const size_t& n, const DenseMvec<U>& object)
+{
+    if (object.gradeBitmap() != (1u << m_grade))
+        return false;
+
+    const U* block = object.gradeData(m_grade);
+    for (unsigned int c=0 ; c < binomialArray[m_grade] ; ++c)
+        m_columns[c * m_count + n] = T(block[c]);
+
+    return true;
+}
+
+// Each column grows by one coefficient, the columns are moved to their new offset from the last one
+template <typename T>
+template <typename U>
+bool PackedArray<T>::push_back(const DenseMvec<U>& object)
+{
+    if (object.gradeBitmap() != (1u << m_grade))
+        return false;
+
+    const size_t count = m_count;
+    const unsigned int columnCount = binomialArray[m_grade];
+    m_columns.resize(columnCount * (count + 1));
+    for (unsigned int c=columnCount ; c-- > 0 ; )
+        std::copy_backward(m_columns.begin() + c * count, m_columns.begin() + (c + 1) * count, 
+                           m_columns.begin() + c * (count + 1) + count);
+    m_count = count + 1;
+
+    return set(count, object);
+}
+
+// Each column shrinks by one coefficient, the coefficients are moved to their new offset from the first one
+template <typename T>
+void PackedArray<T>::erase(const size_t& n)
+{
+    size_t write = 0;
+    for (unsigned int c=0 ; c < binomialArray[m_grade] ; ++c)
+        for (size_t i=0 ; i < m_count ; ++i)
+            if (i != n)
+                m_columns[write++] = m_columns[c * m_count + i];
+
+    m_columns.resize(write);
+    --m_count;
+}
+
+template <typename T>
+template <typename U>
+void PackedArray<T>::unpack(DenseMvec<U>* objects) const
+{
+    for (size_t n=0 ; n < m_count ; ++n)
+        get(n, objects[n]);
+}
+
+template <typename T>
+template <typename U>
+void PackedArray<T>::assign(const PackedArray<U>& other)
+{
+    m_grade = other.m_grade;
+    m_count = other.m_count;
+    m_columns.assign(other.m_columns.begin(), other.m_columns.end());
+}
+
+template <typename T>
+template <typename U>
+void PackedArray<T>::assign(const PackedArray<U>& other, const size_t& offset, const size_t& count)
+{
+    resize(other.m_grade, count);
+    for (unsigned int c=0 ; c < binomialArray[m_grade] ; ++c)
+    {
+        const U* source = other.column(c) + offset;
+        for (size_t n=0 ; n < count ; ++n)
+            m_columns[c * count + n] = T(source[n]);
+    }
+}
+
+template <typename T>
+void PackedArray<T>::dualize()
+{
+    const unsigned int dualGrade = algebraDimension - m_grade;
+    std::vector<T> columns(m_columns.size());
+    for (unsigned int c=0 ; c < binomialArray[dualGrade] ; ++c)
+    {
+        const unsigned int denseIndex = perGradeStartingIndex[dualGrade] + c;
+        const T sign = T(denseDualSigns[denseIndex]);
+        const T* source = column(denseDualSources[denseIndex] - perGradeStartingIndex[m_grade]);
+        for (size_t n=0 ; n < m_count ; ++n)
+            columns[c * m_count + n] = sign * source[n];
+    }
+
+    m_grade = dualGrade;
+    m_columns.swap(columns);
+}
+
+template <typename T>
+void PackedArray<T>::resize(const unsigned int& grade, const size_t& count)
+{
+    m_grade = grade;
+    m_count = count;
+    m_columns.resize(binomialArray[grade] * count);
+}
+
+template <typename T>
+void PackedArray<T>::clear()
+{
+    m_grade = 0;
+    m_count = 0;
+    m_columns.clear();
+}
+
+// Copies the grade <grade> block of objects[indices[n * indexStride]] (objects[n] without indices) into
+// columns of <count> values, reading it from the complementary block of the objects when dual is set
+void gatherBlocks(const DenseMvec<double>* objects, const uint32_t* indices, const size_t& indexStride,
+                  const size_t& count, const unsigned int& grade, const bool& dual, double* columns);
+void gatherBlocks(const PackedArray<double>& objects, const uint32_t* indices, const size_t& indexStride,
+                  const size_t& count, const unsigned int& grade, const bool& dual, double* columns);
+
+// Powers of the pairs of vectors lhs[lhsStart + i] and rhs[rhsStart + j], written to result[i * rhsCount + j] :
+// -2 * (lhs | rhs) once both are normalized by their e0 coefficient. This is the squared distance between
+// two points, d^2 - r^2 between a point and a dual sphere of radius r. Vectors whose e0 coefficient is zero,
+// like dual planes, are left as they are. Both arrays must hold vectors, the blocks are evaluated as a matrix product.
+void vectorPowers(const PackedArray<double>& lhs, const size_t& lhsStart, const size_t& lhsCount,
+                  const PackedArray<double>& rhs, const size_t& rhsStart, const size_t& rhsCount,
+                  double* result);
+
+// Same as pairwiseProduct(), with the rhs objects read directly from their packed columns
+bool pairwiseProduct(const Product& product,
+                     const DenseMvec<double>* lhs, const size_t& lhsCount,
+                     const PackedArray<double>& rhs,
+                     const DenseMvec<double>* trailing,
+                     DenseMvec<double>* result);
+
+
+} // namespace c3ga
+
+
+#endif // C3GABATCH_HPP
@@ -0,0 +1,66 @@
+#include "C3GABatch.hpp"
+
+namespace c3ga {
+namespace detail {
+const BatchKernel* getAvx512BatchKernels();
+} // namespace detail
+} // namespace c3ga
+
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+// Only the kernels are compiled for AVX-512, the headers above must stay out of this section
+// since their static initializers run whatever the CPU.
+// The kernels are only called when the CPU supports them (see getSimdLevel).
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+
+#include "C3GABatchKernels.hpp"
+
+namespace c3ga {
+namespace {
+
+struct Avx512Lanes
+{
+    using Vec = __m512d;
+    static constexpr size_t width = 8;
+
+    static inline Vec load(const double* ptr) { return _mm512_loadu_pd(ptr); }
+    static inline void store(double* ptr, const Vec& v) { _mm512_storeu_pd(ptr, v); }
+    static inline Vec set1(const double& value) { return _mm512_set1_pd(value); }
+    static inline Vec fmadd(const Vec& a, const Vec& b, const Vec& c) { return _mm512_fmadd_pd(a, b, c); }
+};
+
+} // namespace
+
+namespace detail {
+
+const BatchKernel* getAvx512BatchKernels()
+{
+    static constexpr auto kernels = makeBatchKernels<Avx512Lanes>(std::make_index_sequence<216>{});
+    return kernels.data();
+}
+
+} // namespace detail
+} // namespace c3ga
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#else
+
+const c3ga::BatchKernel* c3ga::detail::getAvx512BatchKernels()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef C3GABATCHKERNELS_HPP
+#define C3GABATCHKERNELS_HPP
+
+// Kernel bodies shared by the C3GABatch*.cpp translation units, each of them compiling
+// them for a different instruction set. Everything lives in an unnamed namespace so that the
+// linker never merges an AVX instantiation with the scalar one.
+// Do not include it anywhere else.
+
+#include "C3GABatch.hpp"
+
+namespace c3ga {
+namespace {
+
+
+// A Lanes type wraps the vector instructions of one instruction set
+struct ScalarLanes
+{
+    using Vec = double;
+    static constexpr size_t width = 1;
+
+    static inline Vec load(const double* ptr) { return *ptr; }
+    static inline void store(double* ptr, const Vec& v) { *ptr = v; }
+    static inline Vec set1(const double& value) { return value; }
+    static inline Vec fmadd(const Vec& a, const Vec& b, const Vec& c) { return a * b + c; }
+};
+
+template <typename Lanes, typename Table, size_t... Is>
+inline void accumulateLanes(const typename Lanes::Vec* lhs,
+                            const typename Lanes::Vec* rhs,
+                            typename Lanes::Vec* result,
+                            std::index_sequence<Is...>)
+{
+    ((result[Table::terms[Is].result] = Lanes::fmadd(Lanes::set1(Table::terms[Is].coef) * lhs[Table::terms[Is].lhs],
+                                                     rhs[Table::terms[Is].rhs],
+                                                     result[Table::terms[Is].result])), ...);
+}
+
+template <typename Lanes, unsigned int LhsGrade, unsigned int RhsGrade, unsigned int ResultGrade>
+void batchKernel(const double* lhs, size_t lhsStride,
+                 const double* rhs, size_t rhsStride,
+                 double* result, size_t resultStride,
+                 size_t count)
+{
+    using Table = ProductTable<LhsGrade, RhsGrade, ResultGrade>;
+    using Vec = typename Lanes::Vec;
+    constexpr unsigned int lhsSize = binomialArray[LhsGrade];
+    constexpr unsigned int rhsSize = binomialArray[RhsGrade];
+    constexpr unsigned int resultSize = binomialArray[ResultGrade];
+
+    Vec lhsLanes[lhsSize] = {};
+    Vec rhsLanes[rhsSize] = {};
+    Vec resultLanes[resultSize] = {};
+
+    // Broadcast operands are loaded once for all the lanes
+    if (lhsStride == 0)
+        for (unsigned int c=0 ; c < lhsSize ; ++c)
+            lhsLanes[c] = Lanes::set1(lhs[c]);
+    if (rhsStride == 0)
+        for (unsigned int c=0 ; c < rhsSize ; ++c)
+            rhsLanes[c] = Lanes::set1(rhs[c]);
+
+    size_t n = 0;
+    for ( ; n + Lanes::width <= count ; n += Lanes::width)
+    {
+        if (lhsStride != 0)
+            for (unsigned int c=0 ; c < lhsSize ; ++c)
+                lhsLanes[c] = Lanes::load(lhs + c * lhsStride + n);
+        if (rhsStride != 0)
+            for (unsigned int c=0 ; c < rhsSize ; ++c)
+                rhsLanes[c] = Lanes::load(rhs + c * rhsStride + n);
+        for (unsigned int c=0 ; c < resultSize ; ++c)
+            resultLanes[c] = Lanes::load(result + c * resultStride + n);
+
+        accumulateLanes<Lanes, Table>(lhsLanes, rhsLanes, resultLanes, std::make_index_sequence<Table::count>{});
+
+        for (unsigned int c=0 ; c < resultSize ; ++c)
+            Lanes::store(result + c * resultStride + n, resultLanes[c]);
+    }
+
+    // Remaining lanes
+    if constexpr (Lanes::width > 1)
+    {
+        if (n < count)
+            batchKernel<ScalarLanes, LhsGrade, RhsGrade, ResultGrade>(lhsStride ? lhs + n : lhs, lhsStride,
+                                                                      rhsStride ? rhs + n : rhs, rhsStride,
+                                                                      result + n, resultStride,
+                                                                      count - n);
+    }
+}
+
+template <typename Lanes, unsigned int Index>
+constexpr BatchKernel makeBatchKernel()
+{
+    constexpr unsigned int lhsGrade = Index / 36, rhsGrade = (Index / 6) % 6, resultGrade = Index % 6;
+    if constexpr (ProductTable<lhsGrade, rhsGrade, resultGrade>::count == 0)
+        return nullptr;
+    else
+        return &batchKernel<Lanes, lhsGrade, rhsGrade, resultGrade>;
+}
+
+// Same indexing as detail::productKernels
+template <typename Lanes, size_t... Is>
+constexpr std::array<BatchKernel, sizeof...(Is)> makeBatchKernels(std::index_sequence<Is...>)
+{
+    return {makeBatchKernel<Lanes, Is>()...};
+}
+
+
+} // namespace
+} // namespace c3ga
+
+
+#endif // C3GABATCHKERNELS_HPP
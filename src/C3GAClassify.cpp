@@ -0,0 +1,321 @@
+#include "C3GAClassify.hpp"
+
+#include "C3GABatch.hpp"
+
+#include <algorithm>
+
+namespace c3ga {
+
+
+namespace {
+
+// Working buffers of classifyGrade, reused from one chunk to the next
+struct ClassifyBuffers
+{
+    std::vector<double> blades;
+    std::vector<double> average;
+    std::vector<double> square;
+    std::vector<double> eiOuterMv;
+    std::vector<double> eiNorm;
+    std::vector<double> mvOuterEi;
+    std::vector<double> contracted;
+    std::vector<double> infinityNorm;
+};
+
+// Zeroes <size> values and returns them, as the kernels accumulate into their result
+double* zeroed(std::vector<double>& buffer, const size_t& size)
+{
+    buffer.assign(size, 0.0);
+    return buffer.data();
+}
+
+void classifyGrade(const unsigned int& grade,
+                   const DenseMvec<double>* objects,
+                   const std::vector<uint32_t>& indices,
+                   MvecType* types,
+                   ClassifyBuffers& buffers)
+{
+    const double epsilon = std::numeric_limits<double>::epsilon();
+    const size_t count = indices.size();
+    const unsigned int size = binomialArray[grade];
+    // Padding the columns keeps them from all mapping to the same cache sets when count is a power of two
+    const size_t stride = count + 8;
+
+    double eiVector[5] = {};
+    eiVector[detail::eiBlockIndex] = 1.0;
+    double e0Vector[5] = {};
+    e0Vector[detail::e0BlockIndex] = 1.0;
+
+    // Gather the blades and scale them so that the average of their coeffs is 1, like getTypeOf does
+    buffers.blades.resize(size * stride);
+    double* blades = buffers.blades.data();
+    double* average = zeroed(buffers.average, count);
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        const double* block = objects[indices[n]].gradeData(grade);
+        for (unsigned int c=0 ; c < size ; ++c)
+            blades[c * stride + n] = block[c];
+    }
+    for (unsigned int c=0 ; c < size ; ++c)
+        for (size_t n=0 ; n < count ; ++n)
+            average[n] += std::abs(blades[c * stride + n]);
+    for (size_t n=0 ; n < count ; ++n)
+        average[n] /= size;
+    for (unsigned int c=0 ; c < size ; ++c)
+        for (size_t n=0 ; n < count ; ++n)
+            blades[c * stride + n] /= average[n];
+
+    // mv | mv
+    double* square = zeroed(buffers.square, count);
+    getBatchKernel(grade, grade, 0)(blades, stride, blades, stride, square, stride, count);
+
+    // (ei ^ mv).quadraticNorm()
+    double* eiOuterMv = zeroed(buffers.eiOuterMv, binomialArray[grade + 1] * stride);
+    double* eiNorm = zeroed(buffers.eiNorm, count);
+    getBatchKernel(1, grade, grade + 1)(eiVector, 0, blades, stride, eiOuterMv, stride, count);
+    getBatchKernel(grade + 1, grade + 1, 0)(eiOuterMv, stride, eiOuterMv, stride, eiNorm, stride, count);
+    for (size_t n=0 ; n < count ; ++n)
+        eiNorm[n] *= signReversePerGrade[grade + 1];
+
+    // ((mv ^ ei) | e0).quadraticNorm() for grade 2 and 3, the dual square for grade 4
+    double* infinityNorm = zeroed(buffers.infinityNorm, count);
+    if (grade == 2 || grade == 3)
+    {
+        double* mvOuterEi = zeroed(buffers.mvOuterEi, binomialArray[grade + 1] * stride);
+        double* contracted = zeroed(buffers.contracted, size * stride);
+        getBatchKernel(grade, 1, grade + 1)(blades, stride, eiVector, 0, mvOuterEi, stride, count);
+        getBatchKernel(grade + 1, 1, grade)(mvOuterEi, stride, e0Vector, 0, contracted, stride, count);
+        getBatchKernel(grade, grade, 0)(contracted, stride, contracted, stride, infinityNorm, stride, count);
+        for (size_t n=0 ; n < count ; ++n)
+            infinityNorm[n] *= signReversePerGrade[grade];
+    }
+    else if (grade == 4)
+    {
+        double* dualSphere = zeroed(buffers.contracted, 5 * stride);
+        for (unsigned int i=0 ; i < 5 ; ++i)
+        {
+            const unsigned int denseIndex = perGradeStartingIndex[1] + i;
+            const double sign = denseDualSigns[denseIndex];
+            const double* column = blades + (denseDualSources[denseIndex] - perGradeStartingIndex[4]) * stride;
+            for (size_t n=0 ; n < count ; ++n)
+                dualSphere[i * stride + n] = sign * column[n];
+        }
+        getBatchKernel(1, 1, 0)(dualSphere, stride, dualSphere, stride, infinityNorm, stride, count);
+    }
+
+    // Same decisions as getTypeOf, for each lane
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        const bool squareToZero = std::abs(square[n]) <= 1.0e3 * epsilon;
+        const bool roundObject = !(std::abs(eiNorm[n]) < epsilon);
+
+        MvecType type = MvecType::Unknown;
+        if (roundObject)
+        {
+            // Spheres are told apart from imaginary ones by the square of their dual
+            const double sign = grade == 4 ? infinityNorm[n] : square[n];
+            if (squareToZero)
+                type = detail::roundTypes[grade][0];
+            else if (sign > epsilon)
+                type = detail::roundTypes[grade][1];
+            else if (sign < -epsilon)
+                type = detail::roundTypes[grade][2];
+        }
+        else
+        {
+            const bool onlyInfinityBlades = std::abs(infinityNorm[n]) < epsilon;
+            switch (grade)
+            {
+                case 1: type = MvecType::DualPlane; break;
+                case 2: type = onlyInfinityBlades ? MvecType::FlatPoint : MvecType::DualLine; break;
+                case 3: type = onlyInfinityBlades ? MvecType::Line : MvecType::DualFlatPoint; break;
+                case 4: type = MvecType::Plane; break;
+            }
+        }
+
+        types[indices[n]] = type;
+    }
+}
+
+} // namespace
+
+
+void classifyBatch(const DenseMvec<double>* objects, const size_t& count, MvecType* types)
+{
+    // Objects are handled by chunks small enough for the columns to stay in cache,
+    // the ones sharing the same grade being evaluated together
+    constexpr size_t chunkSize = 256;
+
+    ClassifyBuffers buffers;
+    std::vector<uint32_t> indices[algebraDimension + 1];
+    for (size_t start=0 ; start < count ; start += chunkSize)
+    {
+        const size_t end = std::min(start + chunkSize, count);
+        for (auto& gradeIndices : indices)
+            gradeIndices.clear();
+
+        for (size_t n=start ; n < end ; ++n)
+        {
+            const DenseMvec<double>& mv = objects[n];
+            if (mv.isEmpty())
+                types[n] = MvecType::NullVector;
+            else if (!mv.isHomogeneous())
+                types[n] = MvecType::NonHomogenousMultiVector;
+            else
+                indices[mv.grade()].push_back(n);
+        }
+
+        for (const uint32_t& n : indices[0])
+            types[n] = MvecType::Scalar;
+        for (const uint32_t& n : indices[algebraDimension])
+            types[n] = MvecType::PseudoScalar;
+
+        for (unsigned int grade=1 ; grade < algebraDimension ; ++grade)
+            if (!indices[grade].empty())
+                classifyGrade(grade, objects, indices[grade], types, buffers);
+    }
+}
+
+
+// == Type algebra ==
+
+namespace {
+
+// Algebra dimension compared with signed grades, gradeOf() returning -1 for the types without a single grade
+constexpr int signedDimension = (int)algebraDimension;
+
+// Objects holding ei as a factor, that anything wedged to them still holds
+inline bool isDirectFlat(const MvecType& type)
+{
+    return type == MvecType::FlatPoint || type == MvecType::Line || type == MvecType::Plane;
+}
+
+inline bool isRound(const MvecType& type)
+{
+    const int grade = gradeOf(type);
+    if (grade < 1 || grade >= signedDimension)
+        return false;
+
+    const MvecType* types = detail::roundTypes[grade];
+    return std::find(types, types + 3, type) != types + 3;
+}
+
+// Type of (ei ^ mv) for a multivector of the given grade
+MvecType eiOuterType(const int& grade)
+{
+    if (grade == 0)
+        return MvecType::DualPlane;
+    if (grade + 1 == signedDimension)
+        return MvecType::PseudoScalar;
+    if (grade + 1 > signedDimension)
+        return MvecType::NullVector;
+
+    const MvecType directFlatTypes[] = {MvecType::FlatPoint, MvecType::Line, MvecType::Plane};
+    return directFlatTypes[grade - 1];
+}
+
+TypeInference inferOuterProductType(const TypeInference& lhs, const TypeInference& rhs)
+{
+    const int lhsGrade = gradeOf(lhs.type);
+    const int rhsGrade = gradeOf(rhs.type);
+    if (lhsGrade < 0 || rhsGrade < 0)
+        return TypeInference();
+
+    const int grade = lhsGrade + rhsGrade;
+    if (grade > signedDimension)
+        return MvecType::NullVector;
+    if (grade == signedDimension)
+        return MvecType::PseudoScalar;
+    if (lhsGrade == 0)
+        return rhs;
+    if (rhsGrade == 0)
+        return lhs;
+
+    if (isDirectFlat(lhs.type) || isDirectFlat(rhs.type))
+        return eiOuterType(grade - 1);
+
+    // (P1 ^ P2)^2 = (P1 | P2)^2, two distinct points always make a real pair
+    if (lhs.type == MvecType::Point && rhs.type == MvecType::Point && !lhs.signUnknown && !rhs.signUnknown)
+        return MvecType::PairPoint;
+
+    if (isRound(lhs.type) && isRound(rhs.type))
+        return TypeInference(detail::roundTypes[grade][1], true);
+
+    return TypeInference();
+}
+
+} // namespace
+
+
+TypeInference inferProductType(const Product& product, const TypeInference& lhs, const TypeInference& rhs)
+{
+    const int lhsGrade = gradeOf(lhs.type);
+    const int rhsGrade = gradeOf(rhs.type);
+    if (lhsGrade < 0 || rhsGrade < 0)
+        return TypeInference();
+
+    switch (product)
+    {
+        case Product::Outer:
+            return inferOuterProductType(lhs, rhs);
+
+        case Product::Inner:
+        {
+            if (lhsGrade == 0 || rhsGrade == 0)
+                return MvecType::NullVector;
+            if (lhsGrade == rhsGrade)
+                return MvecType::Scalar;
+
+            // a | B is the dual of a ^ dual(B) up to its sign, a being the operand of lowest grade
+            const TypeInference& lower = lhsGrade < rhsGrade ? lhs : rhs;
+            const TypeInference& higher = lhsGrade < rhsGrade ? rhs : lhs;
+            return dualType(inferOuterProductType(lower, dualType(higher)));
+        }
+
+        case Product::Geometric:
+        {
+            if (lhsGrade == 0)
+                return rhs;
+            if (rhsGrade == 0)
+                return lhs;
+            if (lhsGrade == algebraDimension)
+                return dualType(rhs);
+            if (rhsGrade == algebraDimension)
+                return dualType(lhs);
+            return TypeInference();
+        }
+    }
+
+    return TypeInference();
+}
+
+TypeInference inferProductWithEiType(const Product& product, const TypeInference& mv)
+{
+    const int grade = gradeOf(mv.type);
+    if (grade < 0)
+        return TypeInference();
+
+    switch (product)
+    {
+        case Product::Outer:
+            return eiOuterType(grade);
+
+        case Product::Inner:
+            if (grade == 0)
+                return MvecType::NullVector;
+            // ei | (Y ^ ei) = (ei | Y) ^ ei, objects holding ei keep it
+            if (isDirectFlat(mv.type))
+                return eiOuterType(grade - 2);
+            return dualType(eiOuterType(algebraDimension - grade));
+
+        case Product::Geometric:
+            if (grade == 0)
+                return MvecType::DualPlane;
+            return TypeInference();
+    }
+
+    return TypeInference();
+}
+
+
+} // namespace c3ga
@@ -0,0 +1,269 @@
+#ifndef C3GACLASSIFY_HPP
+#define C3GACLASSIFY_HPP
+
+#include "C3GAUtils.hpp"
+#include "C3GAProducts.hpp"
+
+#include <algorithm>
+
+namespace c3ga {
+
+
+namespace detail {
+
+// Position of e0 and ei in the grade 1 block
+constexpr unsigned int e0BlockIndex = xorIndexToHomogeneousIndex[E0];
+constexpr unsigned int eiBlockIndex = xorIndexToHomogeneousIndex[Ei];
+
+// Scalar part of the product of two blocks of the same grade
+template <typename T>
+inline T scalarProduct(const T* lhs, const T* rhs, const unsigned int& grade)
+{
+    T result = T(0);
+    getProductKernel<T>(grade, grade, 0)(lhs, rhs, &result);
+    return result;
+}
+
+// Same as Mvec::quadraticNorm() on a single block
+template <typename T>
+inline T quadraticNorm(const T* block, const unsigned int& grade)
+{
+    return T(signReversePerGrade[grade]) * scalarProduct(block, block, grade);
+}
+
+// Round objects of grade 1 to 4, by increasing sign of their square: tangent, real and imaginary
+constexpr MvecType roundTypes[algebraDimension][3] = {
+    {},
+    {MvecType::Point, MvecType::DualSphere, MvecType::ImaginaryDualSphere},
+    {MvecType::TangentVector, MvecType::PairPoint, MvecType::DualCircle},
+    {MvecType::TangentBivector, MvecType::Circle, MvecType::ImaginaryCircle},
+    {MvecType::DualPoint, MvecType::Sphere, MvecType::ImaginarySphere},
+};
+
+// numerical stability: scale the block so that the average of its coeffs is 1
+template <typename T>
+inline void normalizeBlade(const T* source, const unsigned int& grade, T* blade)
+{
+    const unsigned int size = binomialArray[grade];
+    T average = T(0);
+    for (unsigned int i=0 ; i < size ; ++i)
+        average += std::abs(source[i]);
+    average /= size;
+
+    for (unsigned int i=0 ; i < size ; ++i)
+        blade[i] = source[i] / average;
+}
+
+// Whether (ei ^ blade) isn't null, which tells round objects from flat ones
+template <typename T>
+inline bool isRoundBlade(const T* blade, const unsigned int& grade)
+{
+    T eiVector[5] = {};
+    eiVector[eiBlockIndex] = T(1);
+    T eiOuterMv[10] = {};
+    getProductKernel<T>(1, grade, grade + 1)(eiVector, blade, eiOuterMv);
+
+    return !(std::abs(quadraticNorm(eiOuterMv, grade + 1)) < std::numeric_limits<T>::epsilon());
+}
+
+// Square of the dual of a grade 4 blade, whose sign tells real spheres from imaginary ones
+template <typename T>
+inline T dualSquare(const T* blade)
+{
+    T dualSphere[5];
+    for (unsigned int i=0 ; i < 5 ; ++i)
+    {
+        const unsigned int denseIndex = perGradeStartingIndex[1] + i;
+        dualSphere[i] = T(denseDualSigns[denseIndex]) * blade[denseDualSources[denseIndex] - perGradeStartingIndex[4]];
+    }
+    return scalarProduct(dualSphere, dualSphere, 1);
+}
+
+// Type of a round blade, from its square and the value telling whether it's real or imaginary
+template <typename T>
+inline MvecType roundType(const unsigned int& grade, const T& square, const T& sign)
+{
+    const T epsilon = std::numeric_limits<T>::epsilon();
+    if (std::abs(square) <= T(1.0e3) * epsilon)
+        return roundTypes[grade][0];
+    if (sign > epsilon)
+        return roundTypes[grade][1];
+    if (sign < -epsilon)
+        return roundTypes[grade][2];
+    return MvecType::Unknown;
+}
+
+} // namespace detail
+
+
+// Allocation-free getTypeOf working on dense multivectors.
+// It performs the same tests as the Mvec version, block by block, and gives the same results.
+template <typename T>
+MvecType getTypeOf(const DenseMvec<T>& mv)
+{
+    // zero error checking
+    const T epsilon = std::numeric_limits<T>::epsilon();
+
+    if (mv.isEmpty())
+        return MvecType::NullVector;
+
+    if (!mv.isHomogeneous())
+        return MvecType::NonHomogenousMultiVector;
+
+    const unsigned int grade = mv.grade();
+    if (grade == 0)
+        return MvecType::Scalar;
+    if (grade == algebraDimension)
+        return MvecType::PseudoScalar;
+
+    T blade[10];
+    detail::normalizeBlade(mv.gradeData(grade), grade, blade);
+
+    // extract properties
+    const T square = detail::scalarProduct(blade, blade, grade);
+    const bool roundObject = detail::isRoundBlade(blade, grade);
+    if (roundObject)
+    {
+        // sphere and imaginary sphere: compute radius from dual
+        return detail::roundType(grade, square, grade == 4 ? detail::dualSquare(blade) : square);
+    }
+
+    // ((mv ^ ei) | e0).quadraticNorm(), for flat points, dual flat points, lines and dual lines
+    auto onlyInfinityBlades = [&]() {
+        T eiVector[5] = {};
+        eiVector[detail::eiBlockIndex] = T(1);
+        T e0Vector[5] = {};
+        e0Vector[detail::e0BlockIndex] = T(1);
+
+        T mvOuterEi[10] = {};
+        detail::getProductKernel<T>(grade, 1, grade + 1)(blade, eiVector, mvOuterEi);
+        T contracted[10] = {};
+        detail::getProductKernel<T>(grade + 1, 1, grade)(mvOuterEi, e0Vector, contracted);
+
+        return std::abs(detail::quadraticNorm(contracted, grade)) < epsilon;
+    };
+
+    switch (grade)
+    {
+        case 1: return MvecType::DualPlane;
+        case 2: return onlyInfinityBlades() ? MvecType::FlatPoint : MvecType::DualLine;
+        case 3: return onlyInfinityBlades() ? MvecType::Line : MvecType::DualFlatPoint;
+        case 4: return MvecType::Plane;
+    }
+
+    return MvecType::Unknown;
+}
+
+// Classifies <count> objects at once, giving the same types as getTypeOf.
+// Objects of the same grade are evaluated together, one per lane of the SIMD batch kernels.
+void classifyBatch(const DenseMvec<double>* objects, const size_t& count, MvecType* types);
+
+
+// == Type algebra ==
+
+// Grade of the objects of a given type, -1 for the types without a single grade
+constexpr int gradeOf(const MvecType& type)
+{
+    if (type == MvecType::Scalar)
+        return 0;
+    if (type >= MvecType::Point && type <= MvecType::DualPlane)
+        return 1;
+    if (type >= MvecType::DualLine && type <= MvecType::TangentVector)
+        return 2;
+    if (type >= MvecType::Line && type <= MvecType::TangentBivector)
+        return 3;
+    if (type >= MvecType::DualPoint && type <= MvecType::Plane)
+        return 4;
+    if (type == MvecType::PseudoScalar)
+        return algebraDimension;
+    return -1;
+}
+
+// Type of the dual of the objects of a given type
+constexpr MvecType dualType(const MvecType& type)
+{
+    switch (type)
+    {
+        case MvecType::Scalar:              return MvecType::PseudoScalar;
+        case MvecType::Point:               return MvecType::DualPoint;
+        case MvecType::DualSphere:          return MvecType::Sphere;
+        case MvecType::ImaginaryDualSphere: return MvecType::ImaginarySphere;
+        case MvecType::DualPlane:           return MvecType::Plane;
+        case MvecType::DualLine:            return MvecType::Line;
+        case MvecType::FlatPoint:           return MvecType::DualFlatPoint;
+        case MvecType::DualCircle:          return MvecType::Circle;
+        case MvecType::PairPoint:           return MvecType::ImaginaryCircle;
+        case MvecType::TangentVector:       return MvecType::TangentBivector;
+        case MvecType::Line:                return MvecType::DualLine;
+        case MvecType::DualFlatPoint:       return MvecType::FlatPoint;
+        case MvecType::Circle:              return MvecType::DualCircle;
+        case MvecType::ImaginaryCircle:     return MvecType::PairPoint;
+        case MvecType::TangentBivector:     return MvecType::TangentVector;
+        case MvecType::DualPoint:           return MvecType::Point;
+        case MvecType::Sphere:              return MvecType::DualSphere;
+        case MvecType::ImaginarySphere:     return MvecType::ImaginaryDualSphere;
+        case MvecType::Plane:               return MvecType::DualPlane;
+        case MvecType::PseudoScalar:        return MvecType::Scalar;
+        default:                            return type;
+    }
+}
+
+// Type of an object deduced from the types of the operands it was built from.
+// When built from round operands, a round object can still be tangent, real or imaginary
+// depending on their position: only the sign of its square is left to compute then.
+struct TypeInference
+{
+    TypeInference(const MvecType& type=MvecType::Unknown, const bool& signUnknown=false) :
+            type(type),
+            signUnknown(signUnknown) {}
+
+    // Unknown when nothing could be deduced, one of the round types of the grade when signUnknown is set
+    MvecType type;
+    bool signUnknown;
+};
+
+// Type of (lhs product rhs), assuming the operands are not degenerate (e.g. concentric spheres)
+TypeInference inferProductType(const Product& product, const TypeInference& lhs, const TypeInference& rhs);
+
+// Type of (mv product ei)
+TypeInference inferProductWithEiType(const Product& product, const TypeInference& mv);
+
+// Type of the dual of the objects of an inferred type
+inline TypeInference dualType(const TypeInference& inference)
+{
+    return TypeInference(dualType(inference.type), inference.signUnknown);
+}
+
+// getTypeOf for an object whose type was inferred, only the tests the inference left open are computed.
+// Degenerate objects, whose grade or roundness differ from the inferred ones, are fully classified.
+template <typename T>
+MvecType getTypeOf(const DenseMvec<T>& mv, const TypeInference& inference)
+{
+    const int grade = gradeOf(inference.type);
+    if (grade < 0 || mv.isEmpty() || !mv.isHomogeneous() || mv.grade() != grade)
+        return getTypeOf(mv);
+
+    if (grade == 0 || grade == algebraDimension)
+        return inference.type;
+
+    const T* source = mv.gradeData(grade);
+    if (std::all_of(source, source + binomialArray[grade], [](const T& coeff) { return coeff == T(0); }))
+        return getTypeOf(mv);
+
+    if (!inference.signUnknown)
+        return inference.type;
+
+    T blade[10];
+    detail::normalizeBlade(source, grade, blade);
+    if (!detail::isRoundBlade(blade, grade))
+        return getTypeOf(mv);
+
+    const T square = detail::scalarProduct(blade, blade, grade);
+    return detail::roundType(grade, square, grade == 4 ? detail::dualSquare(blade) : square);
+}
+
+
+} // namespace c3ga
+
+
+#endif // C3GACLASSIFY_HPP
@@ -0,0 +1,331 @@
+#ifndef C3GAEXPRESSIONS_HPP
+#define C3GAEXPRESSIONS_HPP
+
+#include "C3GAProducts.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace c3ga {
+
+
+// == Lazy products ==
+//
+// Chains of products started with lazy() build an expression instead of computing each
+// intermediate multivector. Evaluating it goes from the result back to the operands :
+// each product only computes the grades its consumer needs, out of the operand grades
+// that can contribute to them, and the last one writes straight into the destination.
+//     c3ga::evaluate(c3ga::lazy(a) * b * c, result, 1 << 2);   // grade 2 part of a * b * c
+// Operands are held by reference and must outlive the expression.
+
+namespace detail {
+
+template <unsigned int Index>
+constexpr uint32_t makeProductGrades()
+{
+    constexpr Product product = Product(Index / 36);
+    constexpr unsigned int lhsGrade = (Index / 6) % 6, rhsGrade = Index % 6;
+    if constexpr (product != Product::Geometric)
+    {
+        return productGrades(product, lhsGrade, rhsGrade);
+    }
+    else
+    {
+        uint32_t grades = 0;
+        if (ProductTable<lhsGrade, rhsGrade, 0>::count) grades |= 1 << 0;
+        if (ProductTable<lhsGrade, rhsGrade, 1>::count) grades |= 1 << 1;
+        if (ProductTable<lhsGrade, rhsGrade, 2>::count) grades |= 1 << 2;
+        if (ProductTable<lhsGrade, rhsGrade, 3>::count) grades |= 1 << 3;
+        if (ProductTable<lhsGrade, rhsGrade, 4>::count) grades |= 1 << 4;
+        if (ProductTable<lhsGrade, rhsGrade, 5>::count) grades |= 1 << 5;
+        return grades;
+    }
+}
+
+// productGrades() of every (product, lhs grade, rhs grade) triple, built from the product tables
+// so that evaluating expressions doesn't expand basis blades at runtime
+template <size_t... Is>
+constexpr std::array<uint32_t, sizeof...(Is)> makeProductGradeTable(std::index_sequence<Is...>)
+{
+    return {makeProductGrades<Is>()...};
+}
+
+inline constexpr auto productGradeTable = makeProductGradeTable(std::make_index_sequence<108>{});
+
+// Grades of the products of a single grade by multivectors of every possible grade bitmap,
+// on each side, so that the grade analysis of an expression is a handful of lookups
+struct ProductGradeBitmaps
+{
+    // [product][lhs grade][rhs grade bitmap]
+    uint32_t byRhsBitmap[3][algebraDimension + 1][64];
+    // [product][lhs grade bitmap][rhs grade]
+    uint32_t byLhsBitmap[3][64][algebraDimension + 1];
+};
+
+constexpr ProductGradeBitmaps makeProductGradeBitmaps()
+{
+    ProductGradeBitmaps result{};
+    for (unsigned int product=0 ; product < 3 ; ++product)
+    {
+        for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+        {
+            for (uint32_t bitmap=0 ; bitmap < 64 ; ++bitmap)
+            {
+                for (unsigned int other=0 ; other <= algebraDimension ; ++other)
+                {
+                    if (!(bitmap & (1 << other)))
+                        continue;
+
+                    result.byRhsBitmap[product][grade][bitmap] |= productGradeTable[product * 36 + grade * 6 + other];
+                    result.byLhsBitmap[product][bitmap][grade] |= productGradeTable[product * 36 + other * 6 + grade];
+                }
+            }
+        }
+    }
+    return result;
+}
+
+inline constexpr ProductGradeBitmaps productGradeBitmaps = makeProductGradeBitmaps();
+
+} // namespace detail
+
+// Bitmap of the grades a product of multivectors of the given grades can have
+inline uint32_t productGradeBitmap(const Product& product, const uint32_t& lhsGrades, const uint32_t& rhsGrades)
+{
+    const auto& table = detail::productGradeBitmaps.byRhsBitmap[(unsigned int)product];
+    uint32_t grades = 0;
+    for (unsigned int lhsGrade=0 ; lhsGrade <= algebraDimension ; ++lhsGrade)
+        if (lhsGrades & (1 << lhsGrade))
+            grades |= table[lhsGrade][rhsGrades];
+    return grades;
+}
+
+// Grades of lhs contributing to the <resultGrades> part of (lhs product rhs)
+inline uint32_t contributingLhsGrades(const Product& product,
+                                      const uint32_t& lhsGrades,
+                                      const uint32_t& rhsGrades,
+                                      const uint32_t& resultGrades)
+{
+    const auto& table = detail::productGradeBitmaps.byRhsBitmap[(unsigned int)product];
+    uint32_t grades = 0;
+    for (unsigned int lhsGrade=0 ; lhsGrade <= algebraDimension ; ++lhsGrade)
+        if ((lhsGrades & (1 << lhsGrade)) && (table[lhsGrade][rhsGrades] & resultGrades))
+            grades |= 1 << lhsGrade;
+    return grades;
+}
+
+// Grades of rhs contributing to the <resultGrades> part of (lhs product rhs)
+inline uint32_t contributingRhsGrades(const Product& product,
+                                      const uint32_t& lhsGrades,
+                                      const uint32_t& rhsGrades,
+                                      const uint32_t& resultGrades)
+{
+    const auto& table = detail::productGradeBitmaps.byLhsBitmap[(unsigned int)product];
+    uint32_t grades = 0;
+    for (unsigned int rhsGrade=0 ; rhsGrade <= algebraDimension ; ++rhsGrade)
+        if ((rhsGrades & (1 << rhsGrade)) && (table[lhsGrades][rhsGrade] & resultGrades))
+            grades |= 1 << rhsGrade;
+    return grades;
+}
+
+// Runtime selection of the dense product functions
+template <typename T>
+inline void applyProduct(const Product& product,
+                         const DenseMvec<T>& lhs,
+                         const DenseMvec<T>& rhs,
+                         DenseMvec<T>& result,
+                         const uint32_t& resultGrades=allGrades)
+{
+    switch (product)
+    {
+        case Product::Outer:     outerProduct(lhs, rhs, result, resultGrades); break;
+        case Product::Inner:     innerProduct(lhs, rhs, result, resultGrades); break;
+        case Product::Geometric: geometricProduct(lhs, rhs, result, resultGrades); break;
+    }
+}
+
+
+// Leaf of an expression, referencing an existing multivector
+template <typename T>
+class MvecOperand
+{
+public:
+    using Scalar = T;
+
+    explicit MvecOperand(const DenseMvec<T>& mv) : m_mv(mv) {}
+
+    // Grades the expression can have
+    inline uint32_t grades() const { return m_mv.gradeBitmap(); }
+
+    // Returns a multivector whose <resultGrades> blocks are the ones of the expression,
+    // either an operand or storage after evaluating into it
+    template <typename Storage>
+    inline const DenseMvec<T>& value(Storage&, const uint32_t&) const { return m_mv; }
+
+    // Leaves don't need any storage to be evaluated
+    struct Storage {};
+
+private:
+    const DenseMvec<T>& m_mv;
+};
+
+template <Product P, typename Lhs, typename Rhs>
+class ProductExpression
+{
+public:
+    using Scalar = typename Lhs::Scalar;
+    static_assert(std::is_same<Scalar, typename Rhs::Scalar>::value, "Operands must have the same scalar type");
+
+    ProductExpression(const Lhs& lhs, const Rhs& rhs) : m_lhs(lhs), m_rhs(rhs) {}
+
+    inline uint32_t grades() const { return productGradeBitmap(P, m_lhs.grades(), m_rhs.grades()); }
+
+    const DenseMvec<Scalar>& value(DenseMvec<Scalar>& storage, const uint32_t& resultGrades) const
+    {
+        // rhs first, so that lhs is pruned with the grades rhs actually has
+        typename Rhs::Storage rhsStorage;
+        const DenseMvec<Scalar>& rhs = m_rhs.value(rhsStorage, contributingRhsGrades(P, m_lhs.grades(), m_rhs.grades(), resultGrades));
+        typename Lhs::Storage lhsStorage;
+        const DenseMvec<Scalar>& lhs = m_lhs.value(lhsStorage, contributingLhsGrades(P, m_lhs.grades(), rhs.gradeBitmap(), resultGrades));
+
+        applyProduct(P, lhs, rhs, storage, resultGrades);
+        return storage;
+    }
+
+    using Storage = DenseMvec<Scalar>;
+
+private:
+    Lhs m_lhs;
+    Rhs m_rhs;
+};
+
+
+namespace detail {
+
+template <typename E>
+struct IsExpression : std::false_type {};
+
+template <typename T>
+struct IsExpression<MvecOperand<T>> : std::true_type {};
+
+template <Product P, typename Lhs, typename Rhs>
+struct IsExpression<ProductExpression<P, Lhs, Rhs>> : std::true_type {};
+
+template <typename E>
+struct IsDenseMvec : std::false_type {};
+
+template <typename T>
+struct IsDenseMvec<DenseMvec<T>> : std::true_type {};
+
+// Lazy operators are picked as soon as one of the operands is an expression
+template <typename Lhs, typename Rhs>
+using EnableLazyProduct = std::enable_if_t<(IsExpression<Lhs>::value || IsExpression<Rhs>::value) &&
+                                           (IsExpression<Lhs>::value || IsDenseMvec<Lhs>::value) &&
+                                           (IsExpression<Rhs>::value || IsDenseMvec<Rhs>::value)>;
+
+template <typename E>
+inline const E& asExpression(const E& expression) { return expression; }
+
+template <typename T>
+inline MvecOperand<T> asExpression(const DenseMvec<T>& mv) { return MvecOperand<T>(mv); }
+
+template <Product P, typename Lhs, typename Rhs>
+inline auto makeProduct(const Lhs& lhs, const Rhs& rhs)
+{
+    using LhsExpression = std::decay_t<decltype(asExpression(lhs))>;
+    using RhsExpression = std::decay_t<decltype(asExpression(rhs))>;
+    return ProductExpression<P, LhsExpression, RhsExpression>(asExpression(lhs), asExpression(rhs));
+}
+
+} // namespace detail
+
+
+// Starts a lazy expression
+template <typename T>
+inline MvecOperand<T> lazy(const DenseMvec<T>& mv)
+{
+    return MvecOperand<T>(mv);
+}
+
+template <typename T>
+MvecOperand<T> lazy(const DenseMvec<T>&& mv) = delete;
+
+template <typename Lhs, typename Rhs, typename = detail::EnableLazyProduct<Lhs, Rhs>>
+inline auto operator^(const Lhs& lhs, const Rhs& rhs)
+{
+    return detail::makeProduct<Product::Outer>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = detail::EnableLazyProduct<Lhs, Rhs>>
+inline auto operator|(const Lhs& lhs, const Rhs& rhs)
+{
+    return detail::makeProduct<Product::Inner>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = detail::EnableLazyProduct<Lhs, Rhs>>
+inline auto operator*(const Lhs& lhs, const Rhs& rhs)
+{
+    return detail::makeProduct<Product::Geometric>(lhs, rhs);
+}
+
+// Evaluates the <resultGrades> part of an expression into result, which must not be one of its operands
+template <typename Expression, typename = std::enable_if_t<detail::IsExpression<Expression>::value>>
+void evaluate(const Expression& expression,
+              DenseMvec<typename Expression::Scalar>& result,
+              const uint32_t& resultGrades=allGrades)
+{
+    using T = typename Expression::Scalar;
+    const DenseMvec<T>& value = expression.value(result, resultGrades);
+    if (&value == &result)
+        return;
+
+    // A lone operand, copied and projected
+    result = value;
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+    {
+        if (result.isGrade(grade) && !(resultGrades & (1 << grade)))
+        {
+            std::fill(result.gradeData(grade), result.gradeData(grade) + binomialArray[grade], T(0));
+            result.setGradeBitmap(result.gradeBitmap() & ~(1 << grade));
+        }
+    }
+}
+
+template <typename Expression, typename = std::enable_if_t<detail::IsExpression<Expression>::value>>
+DenseMvec<typename Expression::Scalar> evaluate(const Expression& expression, const uint32_t& resultGrades=allGrades)
+{
+    DenseMvec<typename Expression::Scalar> result;
+    evaluate(expression, result, resultGrades);
+    return result;
+}
+
+
+// == Sandwich ==
+
+// versor * mv * versorInverse, fused into a single evaluation.
+// Versors preserve grades : only the grades of mv are computed in the last product,
+// the others canceling out. The result must not alias one of the operands.
+template <typename T>
+inline void sandwich(const DenseMvec<T>& versor,
+                     const DenseMvec<T>& mv,
+                     const DenseMvec<T>& versorInverse,
+                     DenseMvec<T>& result)
+{
+    evaluate(lazy(versor) * mv * versorInverse, result, mv.gradeBitmap());
+}
+
+template <typename T>
+inline DenseMvec<T> sandwich(const DenseMvec<T>& versor,
+                             const DenseMvec<T>& mv,
+                             const DenseMvec<T>& versorInverse)
+{
+    DenseMvec<T> result;
+    sandwich(versor, mv, versorInverse, result);
+    return result;
+}
+
+
+} // namespace c3ga
+
+
+#endif // C3GAEXPRESSIONS_HPP
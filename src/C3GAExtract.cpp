@@ -0,0 +1,198 @@
+#include "C3GAExtract.hpp"
+
+#include "C3GABatch.hpp"
+#include "C3GAUtils.hpp"
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace c3ga {
+
+
+namespace {
+
+// Position of a blade in the block of its grade
+constexpr unsigned int blockIndex(const unsigned int& xorIndex)
+{
+    return xorIndexToHomogeneousIndex[xorIndex];
+}
+
+// Broadcast block holding a single blade
+template <unsigned int Grade>
+std::array<double, binomialArray[Grade]> bladeBlock(const unsigned int& xorIndex, const double& value)
+{
+    std::array<double, binomialArray[Grade]> result{};
+    result[blockIndex(xorIndex)] = value;
+    return result;
+}
+
+inline glm::dvec3 euclideanColumns(const double* columns, const size_t& count, const size_t& n)
+{
+    return {columns[blockIndex(E1) * count + n],
+            columns[blockIndex(E2) * count + n],
+            columns[blockIndex(E3) * count + n]};
+}
+
+// Rotation bringing axis onto direction, as done by the Mvec extractors
+inline glm::mat4 rotationTo(const glm::vec3& axis, const glm::vec3& direction)
+{
+    return glm::toMat4(glm::quat{axis, direction});
+}
+
+// Euclidean coordinates of the pair points, as 6 columns : the ones of the first points, then the second ones.
+// With D = -(ei | P), (P +- l) / D = ((P * D)_1 +- l D) / (D | D), P * D only contributing through its grade 1.
+void pairPointColumns(const double* columns, const size_t& count, std::vector<double>& result)
+{
+    std::vector<double> scratch(12 * count, 0.0);
+    double* denominators = scratch.data();
+    double* products = denominators + 5 * count;
+    double* squares = products + 5 * count;
+    double* norms = squares + count;
+
+    const auto minusEi = bladeBlock<1>(Ei, -1.0);
+    getBatchKernel(1, 2, 1)(minusEi.data(), 0, columns, count, denominators, count, count);
+    getBatchKernel(2, 1, 1)(columns, count, denominators, count, products, count, count);
+    getBatchKernel(2, 2, 0)(columns, count, columns, count, squares, count, count);
+    getBatchKernel(1, 1, 0)(denominators, count, denominators, count, norms, count, count);
+
+    result.resize(6 * count);
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        const double lambda = std::sqrt(std::fabs(squares[n]));
+        for (unsigned int k=0 ; k < 3 ; ++k)
+        {
+            const unsigned int c = blockIndex(1 << (k + 1));
+            const double product = products[c * count + n];
+            const double denominator = denominators[c * count + n];
+            result[k * count + n] = (product + lambda * denominator) / norms[n];
+            result[(k + 3) * count + n] = (product - lambda * denominator) / norms[n];
+        }
+    }
+}
+
+} // namespace
+
+
+// == Points ==
+
+void extractPoints(const double* columns, const size_t& count, const bool& normalized, glm::vec3* positions)
+{
+    const double* weights = columns + blockIndex(E0) * count;
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        const double weight = normalized ? 1.0 : weights[n];
+        positions[n] = glm::vec3(columns[blockIndex(E1) * count + n] / weight,
+                                 columns[blockIndex(E2) * count + n] / weight,
+                                 columns[blockIndex(E3) * count + n] / weight);
+    }
+}
+
+void extractFlatPoints(const double* columns, const size_t& count, glm::vec3* positions)
+{
+    std::vector<double> scratch(16 * count, 0.0);
+    double* wedges = scratch.data();
+    double* numerators = wedges + 10 * count;
+    double* denominators = numerators + 5 * count;
+
+    const auto e0 = bladeBlock<1>(E0, 1.0);
+    const auto e0i = bladeBlock<2>(E0 | Ei, 1.0);
+    getBatchKernel(1, 2, 3)(e0.data(), 0, columns, count, wedges, count, count);
+    getBatchKernel(2, 3, 1)(e0i.data(), 0, wedges, count, numerators, count, count);
+    getBatchKernel(2, 2, 0)(e0i.data(), 0, columns, count, denominators, count, count);
+
+    for (size_t n=0 ; n < count ; ++n)
+        positions[n] = glm::vec3(euclideanColumns(numerators, count, n) / -denominators[n]);
+}
+
+void extractPairPoints(const double* columns, const size_t& count, glm::vec3* first, glm::vec3* second)
+{
+    std::vector<double> points;
+    pairPointColumns(columns, count, points);
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        first[n] = glm::vec3(points[n], points[count + n], points[2 * count + n]);
+        second[n] = glm::vec3(points[3 * count + n], points[4 * count + n], points[5 * count + n]);
+    }
+}
+
+
+// == Matrices ==
+
+// A normalized dual sphere (of e0 coefficient 1) already holds its center
+void extractDualSphereMatrices(const double* columns, const size_t& count, const bool& normalized, glm::mat4* matrices)
+{
+    std::vector<double> squares(count, 0.0);
+    getBatchKernel(1, 1, 0)(columns, count, columns, count, squares.data(), count, count);
+
+    const double* weights = columns + blockIndex(E0) * count;
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        const double weight = normalized ? 1.0 : weights[n];
+        const float radius = float(squares[n] / weight);
+
+        glm::mat4& matrix = matrices[n];
+        matrix = glm::mat4(1.0f);
+        matrix[0][0] = matrix[1][1] = matrix[2][2] = radius;
+        matrix[3] = glm::vec4(glm::vec3(euclideanColumns(columns, count, n) / weight), 1.0f);
+    }
+}
+
+void extractDualCircleMatrices(const double* columns, const size_t& count, glm::mat4* matrices)
+{
+    std::vector<double> points;
+    pairPointColumns(columns, count, points);
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        const glm::dvec3 first(points[n], points[count + n], points[2 * count + n]);
+        const glm::dvec3 second(points[3 * count + n], points[4 * count + n], points[5 * count + n]);
+        const glm::dvec3 direction = second - first;
+        const float radius = float(0.5 * glm::length(direction));
+
+        glm::mat4& matrix = matrices[n];
+        matrix = rotationTo(glm::vec3(0, 0, 1), glm::vec3(glm::normalize(direction)));
+        for (unsigned int i=0 ; i < 3 ; ++i)
+            matrix[i] = matrix[i] * radius;
+        matrix[3] = glm::vec4(glm::vec3(0.5 * (first + second)), 1.0f);
+    }
+}
+
+// The origin is the point of the line closest to the world origin : (d x m) / (d | d)
+void extractDualLineMatrices(const double* columns, const size_t& count, glm::mat4* matrices)
+{
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        auto at = [columns, count, n](const unsigned int& xorIndex) { return columns[blockIndex(xorIndex) * count + n]; };
+        const glm::dvec3 direction(at(E2 | E3), -at(E1 | E3), at(E1 | E2));
+        const glm::dvec3 moment(at(E1 | Ei), at(E2 | Ei), at(E3 | Ei));
+
+        glm::mat4& matrix = matrices[n];
+        matrix = rotationTo(glm::vec3(0, 0, 1), glm::vec3(direction));
+        matrix[3] = glm::vec4(glm::vec3(glm::cross(direction, moment) / glm::dot(direction, direction)), 1.0f);
+    }
+}
+
+// We pin the plane to x=0 and z=0, like originAndDirectionFromDualPlane()
+void extractDualPlaneMatrices(const double* columns, const size_t& count, glm::mat4* matrices)
+{
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        const glm::dvec3 normal = euclideanColumns(columns, count, n);
+        const double d = columns[blockIndex(Ei) * count + n];
+
+        glm::dvec3 origin(0.0);
+        if (normal.y != 0)
+            origin.y = d / normal.y;
+        else if (normal.x != 0)
+            origin.x = d / normal.x;
+        else if (normal.z != 0)
+            origin.z = d / normal.z;
+
+        glm::mat4& matrix = matrices[n];
+        matrix = rotationTo(glm::vec3(0, 1, 0), glm::normalize(glm::vec3(normal)));
+        matrix[3] = glm::vec4(glm::vec3(origin), 1.0f);
+    }
+}
+
+
+} // namespace c3ga
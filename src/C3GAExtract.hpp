@@ -0,0 +1,47 @@
+#ifndef C3GAEXTRACT_HPP
+#define C3GAEXTRACT_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+namespace c3ga {
+
+
+// Render features of many objects of a single type at once, the array versions of the
+// extraction functions of C3GAUtils. Objects are read as columns of their grade block, as
+// gathered by gatherBlocks() : coefficient c of the object n at columns[c * count + n].
+// The products the features are made of go through the batch kernels, for all the objects
+// in one pass, and no multivector is built along the way.
+
+
+// == Points ==
+
+// Euclidean positions of points, divided by their e0 coefficient unless they are normalized
+void extractPoints(const double* columns, const size_t& count, const bool& normalized, glm::vec3* positions);
+
+// Positions of flat points (grade 2) : -(e0i | (e0 ^ F)) / (e0i | F)
+void extractFlatPoints(const double* columns, const size_t& count, glm::vec3* positions);
+
+// The two points of pair points (grade 2) : (P +- sqrt(|P | P|)) / -(ei | P)
+void extractPairPoints(const double* columns, const size_t& count, glm::vec3* first, glm::vec3* second);
+
+
+// == Matrices ==
+
+// Same as extractDualSphereMatrix()
+void extractDualSphereMatrices(const double* columns, const size_t& count, const bool& normalized, glm::mat4* matrices);
+
+// Same as extractDualCircleMatrix(), the circle going through the pair points of the dual circle
+void extractDualCircleMatrices(const double* columns, const size_t& count, glm::mat4* matrices);
+
+// Same as extractDualLineMatrix()
+void extractDualLineMatrices(const double* columns, const size_t& count, glm::mat4* matrices);
+
+// Same as extractDualPlaneMatrix()
+void extractDualPlaneMatrices(const double* columns, const size_t& count, glm::mat4* matrices);
+
+
+} // namespace c3ga
+
+#endif // C3GAEXTRACT_HPP
@@ -0,0 +1,265 @@
+#include "C3GAIntersect.hpp"
+
+#include "C3GAClassify.hpp"
+
+namespace c3ga {
+
+
+namespace {
+
+// Positions in the grade 1 block of the basis vectors a blade is made of, by increasing xor index :
+// the blade of xor index (1 << p) | (1 << q) being e_p ^ e_q with p < q.
+template <unsigned int Grade>
+constexpr std::array<std::array<unsigned int, Grade>, binomialArray[Grade]> bladeFactors()
+{
+    std::array<std::array<unsigned int, Grade>, binomialArray[Grade]> result{};
+    for (unsigned int i=0 ; i < binomialArray[Grade] ; ++i)
+    {
+        const unsigned int xorIndex = denseIndexToXorIndex[perGradeStartingIndex[Grade] + i];
+        unsigned int k = 0;
+        for (unsigned int bit=0 ; bit < algebraDimension ; ++bit)
+            if (xorIndex & (1 << bit))
+                result[i][k++] = bit;
+    }
+    return result;
+}
+
+constexpr unsigned int vectorIndex(const unsigned int& bit)
+{
+    return xorIndexToHomogeneousIndex[1 << bit];
+}
+
+constexpr unsigned int bivectorIndex(const unsigned int& bit1, const unsigned int& bit2)
+{
+    return xorIndexToHomogeneousIndex[(1 << bit1) | (1 << bit2)];
+}
+
+// (a ^ b)_pq = a_p b_q - a_q b_p
+struct BivectorMinor { unsigned int p, q; };
+constexpr auto bivectorMinors = []() {
+    std::array<BivectorMinor, 10> result{};
+    const auto factors = bladeFactors<2>();
+    for (unsigned int i=0 ; i < 10 ; ++i)
+        result[i] = {vectorIndex(factors[i][0]), vectorIndex(factors[i][1])};
+    return result;
+}();
+
+// (B ^ v)_pqr = B_pq v_r - B_pr v_q + B_qr v_p
+struct TrivectorMinor { unsigned int p, q, r, pq, pr, qr; };
+constexpr auto trivectorMinors = []() {
+    std::array<TrivectorMinor, 10> result{};
+    const auto factors = bladeFactors<3>();
+    for (unsigned int i=0 ; i < 10 ; ++i)
+    {
+        const auto& f = factors[i];
+        result[i] = {vectorIndex(f[0]), vectorIndex(f[1]), vectorIndex(f[2]),
+                     bivectorIndex(f[0], f[1]), bivectorIndex(f[0], f[2]), bivectorIndex(f[1], f[2])};
+    }
+    return result;
+}();
+
+// (a ^ b ^ c ^ ei)_pqri is the 3x3 minor of a, b and c over e_p, e_q and e_r.
+// The only grade 4 blade without ei is e0123, whose coefficient is always zero.
+struct QuadvectorMinor { unsigned int block, p, q, r; };
+constexpr unsigned int eiBit = 4;
+constexpr auto quadvectorMinors = []() {
+    std::array<QuadvectorMinor, 4> result{};
+    const auto factors = bladeFactors<4>();
+    unsigned int k = 0;
+    for (unsigned int i=0 ; i < 5 ; ++i)
+        if (factors[i][3] == eiBit)
+            result[k++] = {i, vectorIndex(factors[i][0]), vectorIndex(factors[i][1]), vectorIndex(factors[i][2])};
+    return result;
+}();
+
+// Returns the block of <grade> of an object about to hold only that grade
+inline double* resetToGrade(DenseMvec<double>& object, const unsigned int& grade)
+{
+    const uint32_t bitmap = 1 << grade;
+    if (object.gradeBitmap() != bitmap)
+    {
+        object.clear();
+        object.setGradeBitmap(bitmap);
+    }
+    return object.gradeData(grade);
+}
+
+inline void outerVectorVector(const double* a, const double* b, double* result)
+{
+    for (unsigned int i=0 ; i < 10 ; ++i)
+    {
+        const BivectorMinor& m = bivectorMinors[i];
+        result[i] = a[m.p] * b[m.q] - a[m.q] * b[m.p];
+    }
+}
+
+inline void outerBivectorVector(const double* bivector, const double* v, double* result)
+{
+    for (unsigned int i=0 ; i < 10 ; ++i)
+    {
+        const TrivectorMinor& m = trivectorMinors[i];
+        result[i] = bivector[m.pq] * v[m.r] - bivector[m.pr] * v[m.q] + bivector[m.qr] * v[m.p];
+    }
+}
+
+// A bivector and a vector commute under the outer product, both orders share the same kernel
+inline void outerProduct(const Intersection& intersection, const double* lhs, const double* rhs, double* result)
+{
+    switch (intersection)
+    {
+        case Intersection::VectorVector: outerVectorVector(lhs, rhs, result); break;
+        case Intersection::BivectorVector: outerBivectorVector(lhs, rhs, result); break;
+        case Intersection::VectorBivector: outerBivectorVector(rhs, lhs, result); break;
+        case Intersection::None: break;
+    }
+}
+
+// 0 for the types without closed form, their grade otherwise
+unsigned int intersectionGrade(const MvecType& type)
+{
+    switch (type)
+    {
+        case MvecType::Point:
+        case MvecType::DualSphere:
+        case MvecType::ImaginaryDualSphere:
+        case MvecType::DualPlane:
+            return 1;
+
+        case MvecType::DualLine:
+        case MvecType::DualCircle:
+        case MvecType::ImaginaryDualCircle:
+            return 2;
+
+        default:
+            return 0;
+    }
+}
+
+unsigned int commonIntersectionGrade(const MvecType* types, const size_t& count, const bool& dual)
+{
+    if (!count)
+        return 0;
+
+    auto typeGrade = [dual](const MvecType& type) { return intersectionGrade(dual ? dualType(type) : type); };
+    const unsigned int grade = typeGrade(types[0]);
+    for (size_t n=1 ; n < count && grade ; ++n)
+        if (typeGrade(types[n]) != grade)
+            return 0;
+
+    return grade;
+}
+
+Intersection intersectionOfGrades(const unsigned int& lhsGrade, const unsigned int& rhsGrade)
+{
+    if (lhsGrade == 1 && rhsGrade == 1)
+        return Intersection::VectorVector;
+    if (lhsGrade == 2 && rhsGrade == 1)
+        return Intersection::BivectorVector;
+    if (lhsGrade == 1 && rhsGrade == 2)
+        return Intersection::VectorBivector;
+    return Intersection::None;
+}
+
+} // namespace
+
+
+Intersection getIntersection(const MvecType& lhs, const MvecType& rhs)
+{
+    return intersectionOfGrades(intersectionGrade(lhs), intersectionGrade(rhs));
+}
+
+Intersection getIntersection(const MvecType* lhs, const size_t& lhsCount, const bool& lhsDual,
+                             const MvecType* rhs, const size_t& rhsCount, const bool& rhsDual)
+{
+    return intersectionOfGrades(commonIntersectionGrade(lhs, lhsCount, lhsDual),
+                                commonIntersectionGrade(rhs, rhsCount, rhsDual));
+}
+
+bool areVectors(const MvecType* types, const size_t& count, const bool& dual)
+{
+    for (size_t n=0 ; n < count ; ++n)
+        if (gradeOf(dual ? dualType(types[n]) : types[n]) != 1)
+            return false;
+
+    return count > 0;
+}
+
+
+// == Kernels ==
+
+unsigned int intersectionLhsGrade(const Intersection& intersection)
+{
+    return intersection == Intersection::BivectorVector ? 2 : intersection == Intersection::None ? 0 : 1;
+}
+
+unsigned int intersectionRhsGrade(const Intersection& intersection)
+{
+    return intersection == Intersection::VectorBivector ? 2 : intersection == Intersection::None ? 0 : 1;
+}
+
+void pairwiseIntersection(const Intersection& intersection,
+                          const double* lhs, const size_t& lhsCount,
+                          const double* rhs, const size_t& rhsCount,
+                          DenseMvec<double>* result)
+{
+    const unsigned int lhsSize = binomialArray[intersectionLhsGrade(intersection)];
+    const unsigned int rhsSize = binomialArray[intersectionRhsGrade(intersection)];
+    const unsigned int grade = intersectionLhsGrade(intersection) + intersectionRhsGrade(intersection);
+
+    double lhsBlock[10];
+    double rhsBlock[10];
+    for (size_t i=0 ; i < lhsCount ; ++i)
+    {
+        for (unsigned int c=0 ; c < lhsSize ; ++c)
+            lhsBlock[c] = lhs[c * lhsCount + i];
+
+        for (size_t j=0 ; j < rhsCount ; ++j)
+        {
+            for (unsigned int c=0 ; c < rhsSize ; ++c)
+                rhsBlock[c] = rhs[c * rhsCount + j];
+
+            outerProduct(intersection, lhsBlock, rhsBlock, resetToGrade(result[i * rhsCount + j], grade));
+        }
+    }
+}
+
+void elementwiseIntersection(const Intersection& intersection,
+                             const double* lhs, const double* rhs, const size_t& count,
+                             DenseMvec<double>* result)
+{
+    const unsigned int lhsSize = binomialArray[intersectionLhsGrade(intersection)];
+    const unsigned int rhsSize = binomialArray[intersectionRhsGrade(intersection)];
+    const unsigned int grade = intersectionLhsGrade(intersection) + intersectionRhsGrade(intersection);
+
+    double lhsBlock[10];
+    double rhsBlock[10];
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        for (unsigned int c=0 ; c < lhsSize ; ++c)
+            lhsBlock[c] = lhs[c * count + n];
+        for (unsigned int c=0 ; c < rhsSize ; ++c)
+            rhsBlock[c] = rhs[c * count + n];
+
+        outerProduct(intersection, lhsBlock, rhsBlock, resetToGrade(result[n], grade));
+    }
+}
+
+void planesThroughPoints(const double* a, const double* b, const double* c, const size_t& count,
+                         DenseMvec<double>* result)
+{
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        double* block = resetToGrade(result[n], 4);
+        block[xorIndexToHomogeneousIndex[E0 | E1 | E2 | E3]] = 0.0;
+        for (const QuadvectorMinor& m : quadvectorMinors)
+        {
+            auto at = [count, n](const double* columns, const unsigned int& i) { return columns[i * count + n]; };
+            block[m.block] = at(a, m.p) * (at(b, m.q) * at(c, m.r) - at(b, m.r) * at(c, m.q))
+                           - at(a, m.q) * (at(b, m.p) * at(c, m.r) - at(b, m.r) * at(c, m.p))
+                           + at(a, m.r) * (at(b, m.p) * at(c, m.q) - at(b, m.q) * at(c, m.p));
+        }
+    }
+}
+
+
+} // namespace c3ga
@@ -0,0 +1,61 @@
+#ifndef C3GAINTERSECT_HPP
+#define C3GAINTERSECT_HPP
+
+#include "C3GAUtils.hpp"
+#include "DenseMvec.hpp"
+
+namespace c3ga {
+
+
+// Closed-form outer products for the pairs of objects intersections are made of.
+// Operands are read as columns of their grade block, as gathered by gatherBlocks().
+// Every coefficient of the result is a 2x2 or 3x3 minor of the operand coefficients, written
+// straight into the result objects without going through the generic products.
+// Like with ^, the blocks of the result are kept even when they are zero.
+enum class Intersection
+{
+    None = 0,
+    // Dual spheres and dual planes : sphere ^ sphere, sphere ^ plane, plane ^ plane
+    VectorVector,
+    // Dual circles and dual lines with dual spheres and dual planes : circle ^ plane, line ^ plane, ...
+    BivectorVector,
+    VectorBivector,
+};
+
+// Kernel computing the outer product of operands of the given types, None if there is none
+Intersection getIntersection(const MvecType& lhs, const MvecType& rhs);
+
+// Same for all the pairs of two arrays of types, taken as the types of their duals when dual is set.
+// Returns None unless a single kernel applies to all of them.
+Intersection getIntersection(const MvecType* lhs, const size_t& lhsCount, const bool& lhsDual,
+                             const MvecType* rhs, const size_t& rhsCount, const bool& rhsDual);
+
+// Whether the types (or the ones of their duals) are all vectors, for which (a ^ b ^ c ^ ei) has a closed form
+bool areVectors(const MvecType* types, const size_t& count, const bool& dual);
+
+
+// == Kernels ==
+
+// Grades of the operands of an intersection, 0 for None
+unsigned int intersectionLhsGrade(const Intersection& intersection);
+unsigned int intersectionRhsGrade(const Intersection& intersection);
+
+// result[i * rhsCount + j] = lhs[i] ^ rhs[j]. The result must not alias the operands.
+void pairwiseIntersection(const Intersection& intersection,
+                          const double* lhs, const size_t& lhsCount,
+                          const double* rhs, const size_t& rhsCount,
+                          DenseMvec<double>* result);
+
+// result[n] = lhs[n] ^ rhs[n], for count operands
+void elementwiseIntersection(const Intersection& intersection,
+                             const double* lhs, const double* rhs, const size_t& count,
+                             DenseMvec<double>* result);
+
+// result[n] = a[n] ^ b[n] ^ c[n] ^ ei for vectors : the planes through triplets of points
+void planesThroughPoints(const double* a, const double* b, const double* c, const size_t& count,
+                         DenseMvec<double>* result);
+
+
+} // namespace c3ga
+
+#endif // C3GAINTERSECT_HPP
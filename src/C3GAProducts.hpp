@@ -0,0 +1,470 @@
+#ifndef C3GAPRODUCTS_HPP
+#define C3GAPRODUCTS_HPP
+
+#include "DenseMvec.hpp"
+
+#include <array>
+#include <utility>
+#include <cstdint>
+
+namespace c3ga {
+
+
+// == Compile-time product tables ==
+//
+// The geometric product of two basis blades of c3ga is computed at compile time by
+// moving to the orthogonal basis (e+, e1, e2, e3, e-) where
+//     e0 = 0.5 * (e- - e+)      ei = e+ + e-
+// and back. Each (lhs grade, rhs grade, result grade) triple then gets a list of
+// non-zero terms result[r] += coef * lhs[a] * rhs[b], which is unrolled into a
+// straight-line kernel working on the fixed-size grade blocks of DenseMvec.
+
+struct ProductTerm
+{
+    unsigned char lhs;
+    unsigned char rhs;
+    unsigned char result;
+    double coef;
+};
+
+namespace detail {
+
+struct BladeTerm
+{
+    unsigned int blade;
+    double coef;
+};
+
+// Up to two basis vectors (e0 and ei) expand into two terms each
+struct BladeExpansion
+{
+    BladeTerm terms[4];
+    unsigned int count;
+};
+
+constexpr unsigned int bitCount(unsigned int bits)
+{
+    unsigned int count = 0;
+    for ( ; bits ; bits >>= 1)
+        count += bits & 1;
+    return count;
+}
+
+// Sign of the reordering of the basis vectors of lhs followed by the ones of rhs
+constexpr double reorderingSign(unsigned int lhs, const unsigned int& rhs)
+{
+    unsigned int swaps = 0;
+    for (lhs >>= 1 ; lhs ; lhs >>= 1)
+        swaps += bitCount(lhs & rhs);
+    return (swaps & 1) ? -1.0 : 1.0;
+}
+
+// Expands a blade as the outer product of its vectors, each vector being given by
+// its expansion in the other basis. Bits 0 and 4 are the only ones that change.
+constexpr BladeExpansion expandBlade(const unsigned int& blade,
+                                     const BladeTerm (&firstVector)[2],
+                                     const BladeTerm (&lastVector)[2])
+{
+    BladeExpansion result{{{0, 1.0}}, 1};
+    for (unsigned int bit=0 ; bit < algebraDimension ; ++bit)
+    {
+        const unsigned int vec = 1 << bit;
+        if (!(blade & vec))
+            continue;
+
+        BladeExpansion next{};
+        for (unsigned int t=0 ; t < result.count ; ++t)
+        {
+            const BladeTerm& term = result.terms[t];
+            const unsigned int optionCount = (bit == 0 || bit == algebraDimension - 1) ? 2 : 1;
+            for (unsigned int o=0 ; o < optionCount ; ++o)
+            {
+                BladeTerm option = {vec, 1.0};
+                if (bit == 0)
+                    option = firstVector[o];
+                else if (bit == algebraDimension - 1)
+                    option = lastVector[o];
+
+                if (term.blade & option.blade)
+                    continue;
+
+                next.terms[next.count++] = {term.blade | option.blade,
+                                            term.coef * option.coef * reorderingSign(term.blade, option.blade)};
+            }
+        }
+        result = next;
+    }
+
+    return result;
+}
+
+// e0 = -0.5 e+ + 0.5 e-    ei = e+ + e-
+constexpr BladeExpansion toOrthogonal(const unsigned int& blade)
+{
+    return expandBlade(blade, {{1, -0.5}, {16, 0.5}}, {{1, 1.0}, {16, 1.0}});
+}
+
+// e+ = -e0 + 0.5 ei        e- = e0 + 0.5 ei
+constexpr BladeExpansion fromOrthogonal(const unsigned int& blade)
+{
+    return expandBlade(blade, {{1, -1.0}, {16, 0.5}}, {{1, 1.0}, {16, 0.5}});
+}
+
+// Full geometric product of two basis blades, indexed by garamon xor indices
+constexpr std::array<double, denseSize> bladeProduct(const unsigned int& lhs, const unsigned int& rhs)
+{
+    std::array<double, denseSize> result{};
+    const BladeExpansion lhsExp = toOrthogonal(lhs);
+    const BladeExpansion rhsExp = toOrthogonal(rhs);
+    for (unsigned int i=0 ; i < lhsExp.count ; ++i)
+    {
+        for (unsigned int j=0 ; j < rhsExp.count ; ++j)
+        {
+            const unsigned int a = lhsExp.terms[i].blade, b = rhsExp.terms[j].blade;
+            double coef = lhsExp.terms[i].coef * rhsExp.terms[j].coef * reorderingSign(a, b);
+            // e- squares to -1, every other orthogonal vector squares to 1
+            if (a & b & 16)
+                coef = -coef;
+
+            const BladeExpansion back = fromOrthogonal(a ^ b);
+            for (unsigned int k=0 ; k < back.count ; ++k)
+                result[back.terms[k].blade] += coef * back.terms[k].coef;
+        }
+    }
+
+    return result;
+}
+
+template <typename Visitor>
+constexpr void visitProductTerms(const unsigned int& lhsGrade,
+                                 const unsigned int& rhsGrade,
+                                 const unsigned int& resultGrade,
+                                 Visitor& visitor)
+{
+    for (unsigned int a=0 ; a < binomialArray[lhsGrade] ; ++a)
+    {
+        for (unsigned int b=0 ; b < binomialArray[rhsGrade] ; ++b)
+        {
+            const auto product = bladeProduct(denseIndexToXorIndex[perGradeStartingIndex[lhsGrade] + a],
+                                              denseIndexToXorIndex[perGradeStartingIndex[rhsGrade] + b]);
+            for (unsigned int r=0 ; r < binomialArray[resultGrade] ; ++r)
+            {
+                const double coef = product[denseIndexToXorIndex[perGradeStartingIndex[resultGrade] + r]];
+                if (coef != 0.0)
+                    visitor(a, b, r, coef);
+            }
+        }
+    }
+}
+
+constexpr unsigned int countProductTerms(const unsigned int& lhsGrade,
+                                         const unsigned int& rhsGrade,
+                                         const unsigned int& resultGrade)
+{
+    unsigned int count = 0;
+    auto counter = [&count](unsigned int, unsigned int, unsigned int, double) { ++count; };
+    visitProductTerms(lhsGrade, rhsGrade, resultGrade, counter);
+    return count;
+}
+
+template <unsigned int Count>
+constexpr std::array<ProductTerm, Count> makeProductTerms(const unsigned int& lhsGrade,
+                                                         const unsigned int& rhsGrade,
+                                                         const unsigned int& resultGrade)
+{
+    std::array<ProductTerm, Count> terms{};
+    unsigned int index = 0;
+    auto writer = [&terms, &index](unsigned int a, unsigned int b, unsigned int r, double coef) {
+        terms[index++] = {(unsigned char)a, (unsigned char)b, (unsigned char)r, coef};
+    };
+    visitProductTerms(lhsGrade, rhsGrade, resultGrade, writer);
+    return terms;
+}
+
+} // namespace detail
+
+
+// Non-zero terms of the grade <ResultGrade> part of the geometric product of a
+// <LhsGrade>-vector by a <RhsGrade>-vector.
+template <unsigned int LhsGrade, unsigned int RhsGrade, unsigned int ResultGrade>
+struct ProductTable
+{
+    static constexpr unsigned int count = detail::countProductTerms(LhsGrade, RhsGrade, ResultGrade);
+    static constexpr std::array<ProductTerm, count> terms = detail::makeProductTerms<count>(LhsGrade, RhsGrade, ResultGrade);
+};
+
+
+enum class Product
+{
+    Outer,
+    Inner,
+    Geometric
+};
+
+
+// Grade of the blocks written by a product of a <lhsGrade>-vector by a <rhsGrade>-vector.
+// Returns -1 when the product is always zero.
+constexpr int outerProductGrade(const unsigned int& lhsGrade, const unsigned int& rhsGrade)
+{
+    return lhsGrade + rhsGrade <= algebraDimension ? (int)(lhsGrade + rhsGrade) : -1;
+}
+
+constexpr int innerProductGrade(const unsigned int& lhsGrade, const unsigned int& rhsGrade)
+{
+    // Like garamon, the inner product with a scalar is zero
+    if (lhsGrade == 0 || rhsGrade == 0)
+        return -1;
+    return lhsGrade > rhsGrade ? lhsGrade - rhsGrade : rhsGrade - lhsGrade;
+}
+
+// Bitmap of the grades a geometric product of a <lhsGrade>-vector by a <rhsGrade>-vector can have
+constexpr uint32_t geometricProductGrades(const unsigned int& lhsGrade, const unsigned int& rhsGrade)
+{
+    uint32_t grades = 0;
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+        if (detail::countProductTerms(lhsGrade, rhsGrade, grade))
+            grades |= 1 << grade;
+    return grades;
+}
+
+// Bitmap of the grades written by a product of a <lhsGrade>-vector by a <rhsGrade>-vector
+constexpr uint32_t productGrades(const Product& product, const unsigned int& lhsGrade, const unsigned int& rhsGrade)
+{
+    switch (product)
+    {
+        case Product::Outer: {
+            const int grade = outerProductGrade(lhsGrade, rhsGrade);
+            return grade < 0 ? 0 : 1 << grade;
+        }
+        case Product::Inner: {
+            const int grade = innerProductGrade(lhsGrade, rhsGrade);
+            return grade < 0 ? 0 : 1 << grade;
+        }
+        case Product::Geometric:
+            return geometricProductGrades(lhsGrade, rhsGrade);
+    }
+
+    return 0;
+}
+
+
+// == Kernels ==
+
+// Accumulates the grade <ResultGrade> part of lhs * rhs into result, where lhs, rhs
+// and result point to the corresponding grade blocks.
+namespace detail {
+
+template <typename Table, typename T, size_t... Is>
+inline void accumulateTerms(const T* lhs, const T* rhs, T* result, std::index_sequence<Is...>)
+{
+    ((result[Table::terms[Is].result] += T(Table::terms[Is].coef) * lhs[Table::terms[Is].lhs] * rhs[Table::terms[Is].rhs]), ...);
+}
+
+} // namespace detail
+
+template <unsigned int LhsGrade, unsigned int RhsGrade, unsigned int ResultGrade, typename T>
+inline void accumulateProduct(const T* lhs, const T* rhs, T* result)
+{
+    using Table = ProductTable<LhsGrade, RhsGrade, ResultGrade>;
+    detail::accumulateTerms<Table>(lhs, rhs, result, std::make_index_sequence<Table::count>{});
+}
+
+// Statically selected products between blocks of known grades.
+// The result block must be zeroed (or hold a value to accumulate into).
+template <unsigned int LhsGrade, unsigned int RhsGrade, typename T>
+inline void outerProduct(const T* lhs, const T* rhs, T* result)
+{
+    static_assert(LhsGrade + RhsGrade <= algebraDimension, "Outer product is always zero for these grades");
+    accumulateProduct<LhsGrade, RhsGrade, LhsGrade + RhsGrade>(lhs, rhs, result);
+}
+
+template <unsigned int LhsGrade, unsigned int RhsGrade, typename T>
+inline void innerProduct(const T* lhs, const T* rhs, T* result)
+{
+    static_assert(innerProductGrade(LhsGrade, RhsGrade) >= 0, "Inner product is always zero for these grades");
+    accumulateProduct<LhsGrade, RhsGrade, (unsigned int)innerProductGrade(LhsGrade, RhsGrade)>(lhs, rhs, result);
+}
+
+
+namespace detail {
+
+template <typename T>
+using ProductKernel = void(*)(const T*, const T*, T*);
+
+template <typename T, unsigned int Index>
+constexpr ProductKernel<T> makeProductKernel()
+{
+    constexpr unsigned int lhsGrade = Index / 36, rhsGrade = (Index / 6) % 6, resultGrade = Index % 6;
+    if constexpr (ProductTable<lhsGrade, rhsGrade, resultGrade>::count == 0)
+        return nullptr;
+    else
+        return &accumulateProduct<lhsGrade, rhsGrade, resultGrade, T>;
+}
+
+// Kernels of every (lhs grade, rhs grade, result grade) triple, used when the grades are
+// only known at runtime. Triples that are always zero have no kernel.
+template <typename T, size_t... Is>
+constexpr std::array<ProductKernel<T>, sizeof...(Is)> makeProductKernels(std::index_sequence<Is...>)
+{
+    return {makeProductKernel<T, Is>()...};
+}
+
+template <typename T>
+inline constexpr auto productKernels = makeProductKernels<T>(std::make_index_sequence<216>{});
+
+template <typename T>
+inline ProductKernel<T> getProductKernel(const unsigned int& lhsGrade,
+                                         const unsigned int& rhsGrade,
+                                         const unsigned int& resultGrade)
+{
+    return productKernels<T>[lhsGrade * 36 + rhsGrade * 6 + resultGrade];
+}
+
+template <typename T>
+inline bool isBlockZero(const DenseMvec<T>& mv, const unsigned int& grade)
+{
+    const T* block = mv.gradeData(grade);
+    for (unsigned int i=0 ; i < binomialArray[grade] ; ++i)
+        if (block[i] != T(0))
+            return false;
+    return true;
+}
+
+} // namespace detail
+
+
+// Bitmap holding every grade of the algebra
+constexpr uint32_t allGrades = (1 << (algebraDimension + 1)) - 1;
+
+// Products between dense multivectors, with the same grade semantics as the garamon operators :
+// the outer product keeps every block it writes while the inner and geometric products
+// drop the blocks that end up being zero.
+// Only the blocks of resultGrades are computed, which gives the grade projection of the product.
+// The result must not alias one of the operands.
+template <typename T>
+void outerProduct(const DenseMvec<T>& lhs, const DenseMvec<T>& rhs, DenseMvec<T>& result,
+                  const uint32_t& resultGrades=allGrades)
+{
+    result.clear();
+    uint32_t bitmap = 0;
+    for (unsigned int lhsGrade=0 ; lhsGrade <= algebraDimension ; ++lhsGrade)
+    {
+        if (!lhs.isGrade(lhsGrade))
+            continue;
+
+        for (unsigned int rhsGrade=0 ; rhsGrade + lhsGrade <= algebraDimension ; ++rhsGrade)
+        {
+            if (!rhs.isGrade(rhsGrade))
+                continue;
+
+            const unsigned int resultGrade = lhsGrade + rhsGrade;
+            if (!(resultGrades & (1 << resultGrade)))
+                continue;
+
+            if (auto kernel = detail::getProductKernel<T>(lhsGrade, rhsGrade, resultGrade))
+                kernel(lhs.gradeData(lhsGrade), rhs.gradeData(rhsGrade), result.gradeData(resultGrade));
+            bitmap |= 1 << resultGrade;
+        }
+    }
+    result.setGradeBitmap(bitmap);
+}
+
+template <typename T>
+void innerProduct(const DenseMvec<T>& lhs, const DenseMvec<T>& rhs, DenseMvec<T>& result,
+                  const uint32_t& resultGrades=allGrades)
+{
+    result.clear();
+    uint32_t bitmap = 0;
+    for (unsigned int lhsGrade=1 ; lhsGrade <= algebraDimension ; ++lhsGrade)
+    {
+        if (!lhs.isGrade(lhsGrade))
+            continue;
+
+        for (unsigned int rhsGrade=1 ; rhsGrade <= algebraDimension ; ++rhsGrade)
+        {
+            if (!rhs.isGrade(rhsGrade))
+                continue;
+
+            const unsigned int resultGrade = innerProductGrade(lhsGrade, rhsGrade);
+            if (!(resultGrades & (1 << resultGrade)))
+                continue;
+
+            if (auto kernel = detail::getProductKernel<T>(lhsGrade, rhsGrade, resultGrade))
+            {
+                kernel(lhs.gradeData(lhsGrade), rhs.gradeData(rhsGrade), result.gradeData(resultGrade));
+                bitmap |= 1 << resultGrade;
+            }
+        }
+    }
+
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+        if ((bitmap & (1 << grade)) && detail::isBlockZero(result, grade))
+            bitmap &= ~(1 << grade);
+    result.setGradeBitmap(bitmap);
+}
+
+template <typename T>
+void geometricProduct(const DenseMvec<T>& lhs, const DenseMvec<T>& rhs, DenseMvec<T>& result,
+                      const uint32_t& resultGrades=allGrades)
+{
+    result.clear();
+    uint32_t bitmap = 0;
+    for (unsigned int lhsGrade=0 ; lhsGrade <= algebraDimension ; ++lhsGrade)
+    {
+        if (!lhs.isGrade(lhsGrade))
+            continue;
+
+        for (unsigned int rhsGrade=0 ; rhsGrade <= algebraDimension ; ++rhsGrade)
+        {
+            if (!rhs.isGrade(rhsGrade))
+                continue;
+
+            for (unsigned int resultGrade=0 ; resultGrade <= algebraDimension ; ++resultGrade)
+            {
+                if (!(resultGrades & (1 << resultGrade)))
+                    continue;
+
+                if (auto kernel = detail::getProductKernel<T>(lhsGrade, rhsGrade, resultGrade))
+                {
+                    kernel(lhs.gradeData(lhsGrade), rhs.gradeData(rhsGrade), result.gradeData(resultGrade));
+                    bitmap |= 1 << resultGrade;
+                }
+            }
+        }
+    }
+
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+        if ((bitmap & (1 << grade)) && detail::isBlockZero(result, grade))
+            bitmap &= ~(1 << grade);
+    result.setGradeBitmap(bitmap);
+}
+
+template <typename T>
+inline DenseMvec<T> operator^(const DenseMvec<T>& lhs, const DenseMvec<T>& rhs)
+{
+    DenseMvec<T> result;
+    outerProduct(lhs, rhs, result);
+    return result;
+}
+
+template <typename T>
+inline DenseMvec<T> operator|(const DenseMvec<T>& lhs, const DenseMvec<T>& rhs)
+{
+    DenseMvec<T> result;
+    innerProduct(lhs, rhs, result);
+    return result;
+}
+
+template <typename T>
+inline DenseMvec<T> operator*(const DenseMvec<T>& lhs, const DenseMvec<T>& rhs)
+{
+    DenseMvec<T> result;
+    geometricProduct(lhs, rhs, result);
+    return result;
+}
+
+
+} // namespace c3ga
+
+
+#endif // C3GAPRODUCTS_HPP
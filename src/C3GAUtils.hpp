@@ -75,11 +75,17 @@ Mvec<T> vector(const T& x, const T& y, const T& z)
     return result;
 }
 
+template <typename T, typename Engine>
+Mvec<T> randomVector(Engine& engine)
+{		
+    std::uniform_real_distribution<T> distrib(-1.0, 1.0);
+    return vector(distrib(engine), distrib(engine), distrib(engine));
+}
+
 template <typename T>
 Mvec<T> randomVector()
 {		
-    std::uniform_real_distribution<T> distrib(-1.0, 1.0);
-    return vector(distrib(generator), distrib(generator), distrib(generator));
+    return randomVector<T>(generator);
 }
 
 
@@ -107,7 +113,7 @@ template <typename T>
 struct Sandwich
 {
     Mvec<T> mvec;
-    inline Mvec<T> operator()(const Mvec<T>& mv) const { return mvec * mv * mv.inv(); }
+    inline Mvec<T> operator()(const Mvec<T>& mv) const { return mvec * mv * mvec.inv(); }
 };
 
 template <typename T>
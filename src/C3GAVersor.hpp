@@ -0,0 +1,385 @@
+#ifndef C3GAVERSOR_HPP
+#define C3GAVERSOR_HPP
+
+#include "C3GAExpressions.hpp"
+#include "C3GABatch.hpp"
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace c3ga {
+
+
+// == Versors ==
+//
+// A versor V (rotor, translator, motor, dilator...) satisfies V * ~V = <V * ~V>_0,
+// so its inverse is given by its reverse without going through a general inverse.
+
+// Scalar part of mv * ~mv
+template <typename T>
+inline T reverseNorm(const DenseMvec<T>& mv)
+{
+    DenseMvec<T> square;
+    geometricProduct(mv, mv.reverse(), square, 1 << 0);
+    return square.gradeData(0)[0];
+}
+
+// Inverse of a versor in closed form : ~V / <V * ~V>_0
+template <typename T>
+inline DenseMvec<T> versorInverse(const DenseMvec<T>& versor)
+{
+    return versor.reverse() / reverseNorm(versor);
+}
+
+
+namespace detail {
+
+template <typename T>
+inline DenseMvec<T> scalarMvec(const T& value)
+{
+    DenseMvec<T> result;
+    result[0] = value;
+    return result;
+}
+
+// Largest absolute coefficient of the grade <grade> block
+template <typename T>
+inline T blockMaxCoeff(const DenseMvec<T>& mv, const unsigned int& grade)
+{
+    const T* block = mv.gradeData(grade);
+    T result = T(0);
+    for (unsigned int i=0 ; i < binomialArray[grade] ; ++i)
+        result = std::max(result, std::abs(block[i]));
+    return result;
+}
+
+// exp of a 2-blade, given its square
+template <typename T>
+inline DenseMvec<T> bladeExp(const DenseMvec<T>& blade, const T& square)
+{
+    if (square < T(0))
+    {
+        const T angle = std::sqrt(-square);
+        return scalarMvec(std::cos(angle)) + blade * T(std::sin(angle) / angle);
+    }
+    if (square > T(0))
+    {
+        const T angle = std::sqrt(square);
+        return scalarMvec(std::cosh(angle)) + blade * T(std::sinh(angle) / angle);
+    }
+    return scalarMvec(T(1)) + blade;
+}
+
+// log of the rotor c + S of a 2-blade, given k * S, its square and k * c for any k > 0
+template <typename T>
+inline DenseMvec<T> bladeLog(const DenseMvec<T>& blade, const T& square, const T& scalar)
+{
+    if (square < T(0))
+    {
+        const T sine = std::sqrt(-square);
+        return blade * T(std::atan2(sine, scalar) / sine);
+    }
+    if (square > T(0))
+    {
+        const T sine = std::sqrt(square);
+        return blade * T(std::atanh(sine / scalar) / sine);
+    }
+    return blade / scalar;
+}
+
+// exp by scaling and squaring of its series, for the bivectors that can't be split
+template <typename T>
+DenseMvec<T> seriesExp(const DenseMvec<T>& mv)
+{
+    T norm = T(0);
+    for (unsigned int i=0 ; i < denseSize ; ++i)
+        norm = std::max(norm, std::abs(mv.data()[i]));
+
+    int squarings = 0;
+    if (norm > T(0.25))
+        squarings = (int)std::ceil(std::log2(norm / T(0.25)));
+    const DenseMvec<T> scaled = mv / T(std::ldexp(1.0, squarings));
+
+    DenseMvec<T> result = scalarMvec(T(1));
+    DenseMvec<T> term = result;
+    for (unsigned int k=1 ; k <= 12 ; ++k)
+    {
+        term = term * scaled / T(k);
+        result += term;
+    }
+
+    for (int i=0 ; i < squarings ; ++i)
+        result = result * result;
+    return result;
+}
+
+} // namespace detail
+
+
+// exp of a bivector in closed form, giving the rotors, translators and motors of c3ga.
+// A bivector B is the sum of two commuting 2-blades B1 + B2 whose squares are the roots of
+//     x^2 - <B^2>_0 x + <B^2>_4^2 / 4
+// (Dorst & Valkenburg, Square Root and Logarithm of Rotors in 3D Conformal Geometric Algebra),
+// and exp(B) = exp(B1) * exp(B2) where each exponential is a cos, cosh or 1 + Bi.
+template <typename T>
+DenseMvec<T> exp(const DenseMvec<T>& bivector)
+{
+    DenseMvec<T> square;
+    geometricProduct(bivector, bivector, square, (1 << 0) | (1 << 4));
+    const T scalarSquare = square.gradeData(0)[0];
+
+    DenseMvec<T> quadvector;
+    const T* block = square.gradeData(4);
+    std::copy(block, block + binomialArray[4], quadvector.gradeData(4));
+    quadvector.setGradeBitmap(square.gradeBitmap() & (1 << 4));
+
+    // A 2-blade squares to a scalar
+    const T epsilon = std::numeric_limits<T>::epsilon();
+    const T scale = std::max(std::abs(scalarSquare), T(1));
+    if (detail::blockMaxCoeff(square, 4) <= epsilon * scale)
+        return detail::bladeExp(bivector, scalarSquare);
+
+    DenseMvec<T> quadSquare;
+    geometricProduct(quadvector, quadvector, quadSquare, 1 << 0);
+    const T q = quadSquare.gradeData(0)[0];
+
+    // Both blades have the same square, the split is undetermined
+    const T discriminant = scalarSquare * scalarSquare - q;
+    if (discriminant <= epsilon * scale * scale)
+        return detail::seriesExp(bivector);
+
+    const T root = std::sqrt(discriminant);
+    const T square1 = T(0.5) * (scalarSquare + root);
+    const T square2 = T(0.5) * (scalarSquare - root);
+
+    // B * (B1 * B2) = square2 * B1 + square1 * B2, with B1 * B2 = <B^2>_4 / 2
+    DenseMvec<T> mixed;
+    geometricProduct(bivector, quadvector, mixed, 1 << 2);
+    const DenseMvec<T> blade1 = (bivector * square1 - mixed * T(0.5)) / root;
+    const DenseMvec<T> blade2 = bivector - blade1;
+
+    DenseMvec<T> result;
+    geometricProduct(detail::bladeExp(blade1, square1), detail::bladeExp(blade2, square2), result, (1 << 0) | (1 << 2) | (1 << 4));
+    return result;
+}
+
+// log of a normalized rotor, translator or motor (grades 0, 2 and 4), the inverse of exp().
+// Rotors whose scalar part is zero (half turns combined with another motion) and the ones
+// whose two blades have the same square aren't supported.
+template <typename T>
+DenseMvec<T> log(const DenseMvec<T>& versor)
+{
+    const T scalar = versor.gradeData(0)[0];
+
+    DenseMvec<T> bivector;
+    const T* block = versor.gradeData(2);
+    std::copy(block, block + binomialArray[2], bivector.gradeData(2));
+    bivector.setGradeBitmap(1 << 2);
+
+    DenseMvec<T> quadvector;
+    block = versor.gradeData(4);
+    std::copy(block, block + binomialArray[4], quadvector.gradeData(4));
+    quadvector.setGradeBitmap(1 << 4);
+
+    DenseMvec<T> square;
+    geometricProduct(bivector, bivector, square, 1 << 0);
+    const T bivectorSquare = square.gradeData(0)[0];
+
+    // With V = (c1 + S1) * (c2 + S2), the grade 2 part P1 + P2 = c2 * S1 + c1 * S2 splits like a bivector,
+    // the grade 4 part giving P1 * P2 = c1 * c2 * S1 * S2 = <V>_0 * <V>_4
+    DenseMvec<T> quadSquare;
+    geometricProduct(quadvector, quadvector, quadSquare, 1 << 0);
+    const T q = scalar * scalar * quadSquare.gradeData(0)[0];
+
+    const T epsilon = std::numeric_limits<T>::epsilon();
+    const T scale = std::max(std::abs(bivectorSquare), T(1));
+    const T discriminant = bivectorSquare * bivectorSquare - T(4) * q;
+    if (detail::blockMaxCoeff(versor, 4) <= epsilon * scale || discriminant <= epsilon * scale * scale)
+        return detail::bladeLog(bivector, bivectorSquare, scalar);
+
+    const T root = std::sqrt(discriminant);
+    const T square1 = T(0.5) * (bivectorSquare + root);
+    const T square2 = T(0.5) * (bivectorSquare - root);
+
+    DenseMvec<T> mixed;
+    geometricProduct(bivector, quadvector, mixed, 1 << 2);
+    const DenseMvec<T> part1 = (bivector * square1 - mixed * scalar) / root;
+    const DenseMvec<T> part2 = bivector - part1;
+
+    DenseMvec<T> result = detail::bladeLog(part1, square1, scalar) + detail::bladeLog(part2, square2, scalar);
+    result.setGradeBitmap(1 << 2);
+    return result;
+}
+
+
+// A versor kept normalized, V * ~V = ±1, so that its inverse is its reverse up to that sign
+// and applying it is a single fused sandwich.
+template <typename T>
+class Versor
+{
+public:
+    Versor() : m_versor(detail::scalarMvec(T(1))), m_inverse(m_versor) {}
+
+    // A null versor (e.g. built from degenerate objects) has no inverse : the result falls back
+    // to the identity and isValid() returns false, instead of spreading NaNs downstream.
+    explicit Versor(const DenseMvec<T>& versor) : m_versor(versor)
+    {
+        const T norm = reverseNorm(versor);
+        if (!(std::abs(norm) > std::numeric_limits<T>::epsilon()) || !std::isfinite(norm))
+        {
+            m_versor = detail::scalarMvec(T(1));
+            m_inverse = m_versor;
+            m_valid = false;
+            return;
+        }
+
+        m_versor /= T(std::sqrt(std::abs(norm)));
+        m_inverse = m_versor.reverse();
+        if (norm < T(0))
+            m_inverse *= T(-1);
+    }
+
+    // exp of a bivector, which is normalized already
+    static Versor fromBivector(const DenseMvec<T>& bivector)
+    {
+        Versor result;
+        result.m_versor = exp(bivector);
+        result.m_inverse = result.m_versor.reverse();
+        return result;
+    }
+
+    inline const DenseMvec<T>& value() const { return m_versor; }
+    inline const DenseMvec<T>& inverse() const { return m_inverse; }
+    inline bool isValid() const { return m_valid; }
+
+    // versor * mv * inverse, the result must not alias mv
+    inline void apply(const DenseMvec<T>& mv, DenseMvec<T>& result) const { sandwich(m_versor, mv, m_inverse, result); }
+    inline DenseMvec<T> apply(const DenseMvec<T>& mv) const { return sandwich(m_versor, mv, m_inverse); }
+
+    // Applying the result is applying other, then this versor
+    Versor operator*(const Versor& other) const
+    {
+        Versor result;
+        result.m_versor = m_versor * other.m_versor;
+        result.m_inverse = other.m_inverse * m_inverse;
+        result.m_valid = m_valid && other.m_valid;
+        return result;
+    }
+
+private:
+    DenseMvec<T> m_versor;
+    DenseMvec<T> m_inverse;
+    bool m_valid = true;
+};
+
+
+// == Versor matrices ==
+
+// The sandwich by a versor is a linear map that keeps the grades : compiled once into one matrix
+// per grade, it transforms whole arrays of objects with a matrix product per grade instead of
+// two geometric products per object.
+template <typename T>
+class VersorMatrix
+{
+public:
+    using Matrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+
+    VersorMatrix() : VersorMatrix(Versor<T>()) {}
+    explicit VersorMatrix(const Versor<T>& versor);
+
+    // Map restricted to the grade <grade>, a square matrix of size binomialArray[grade]
+    inline const Matrix& block(const unsigned int& grade) const { return m_blocks[grade]; }
+
+    // result[n] = versor * objects[n] * inverse, keeping the grades of each object. Result may alias objects.
+    void apply(const DenseMvec<T>* objects, const size_t& count, DenseMvec<T>* result) const;
+    // Same on packed objects, result may be objects
+    void apply(const PackedArray<T>& objects, PackedArray<T>& result) const;
+
+private:
+    Matrix m_blocks[algebraDimension + 1];
+};
+
+template <typename T>
+VersorMatrix<T>::VersorMatrix(const Versor<T>& versor)
+{
+    // The columns are the images of the basis blades
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+    {
+        const unsigned int size = binomialArray[grade];
+        m_blocks[grade].resize(size, size);
+        for (unsigned int c=0 ; c < size ; ++c)
+        {
+            DenseMvec<T> blade;
+            blade.gradeData(grade)[c] = T(1);
+            blade.setGradeBitmap(1 << grade);
+
+            const DenseMvec<T> image = versor.apply(blade);
+            const T* block = image.gradeData(grade);
+            for (unsigned int r=0 ; r < size ; ++r)
+                m_blocks[grade](r, c) = block[r];
+        }
+    }
+}
+
+template <typename T>
+void VersorMatrix<T>::apply(const DenseMvec<T>* objects, const size_t& count, DenseMvec<T>* result) const
+{
+    // Chunks of objects small enough for their blocks to stay in cache between the grades
+    constexpr size_t chunkSize = 256;
+
+    // The blocks of consecutive objects are columns of a matrix, strided by the size of the objects
+    using Stride = Eigen::OuterStride<>;
+    const Stride stride(sizeof(DenseMvec<T>) / sizeof(T));
+
+    Matrix transformed;
+    for (size_t start=0 ; start < count ; start += chunkSize)
+    {
+        const size_t size = std::min(chunkSize, count - start);
+
+        uint32_t grades = 0;
+        for (size_t n=start ; n < start + size ; ++n)
+            grades |= objects[n].gradeBitmap();
+
+        for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+        {
+            Eigen::Map<Matrix, 0, Stride> resultBlades(result[start].gradeData(grade), binomialArray[grade], size, stride);
+            if (!(grades & (1 << grade)))
+            {
+                if (result != objects)
+                    resultBlades.setZero();
+                continue;
+            }
+
+            Eigen::Map<const Matrix, 0, Stride> blades(objects[start].gradeData(grade), binomialArray[grade], size, stride);
+            transformed.noalias() = m_blocks[grade] * blades;
+            resultBlades = transformed;
+        }
+
+        if (result != objects)
+            for (size_t n=start ; n < start + size ; ++n)
+                result[n].setGradeBitmap(objects[n].gradeBitmap());
+    }
+}
+
+template <typename T>
+void VersorMatrix<T>::apply(const PackedArray<T>& objects, PackedArray<T>& result) const
+{
+    using RowMatrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    // Packed columns are the rows of a matrix with one column per object
+    const unsigned int grade = objects.grade();
+    const size_t count = objects.size();
+    const RowMatrix transformed = m_blocks[grade] * Eigen::Map<const RowMatrix>(objects.data(), binomialArray[grade], count);
+
+    result.resize(grade, count);
+    Eigen::Map<RowMatrix>(result.data(), binomialArray[grade], count) = transformed;
+}
+
+
+} // namespace c3ga
+
+
+#endif // C3GAVERSOR_HPP
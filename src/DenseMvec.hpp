@@ -0,0 +1,329 @@
+#ifndef DENSEMVEC_HPP
+#define DENSEMVEC_HPP
+
+#include <c3ga/Mvec.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace c3ga {
+
+
+// Number of coefficients of a full c3ga multivector
+constexpr unsigned int denseSize = 32;
+
+// Coefficients are stored grade by grade, in the same order as garamon's k-vectors
+// (scalar, e0..ei, e01..e3i, ...). This table maps a garamon basis index (E1, E23, ...)
+// to its position in that layout.
+constexpr std::array<unsigned int, denseSize> xorIndexToDenseIndex = []() {
+    std::array<unsigned int, denseSize> result{};
+    for (unsigned int idx=0 ; idx < denseSize ; ++idx)
+        result[idx] = perGradeStartingIndex[xorIndexToGrade[idx]] + xorIndexToHomogeneousIndex[idx];
+    return result;
+}();
+
+// Inverse of xorIndexToDenseIndex
+constexpr std::array<unsigned int, denseSize> denseIndexToXorIndex = []() {
+    std::array<unsigned int, denseSize> result{};
+    for (unsigned int idx=0 ; idx < denseSize ; ++idx)
+        result[xorIndexToDenseIndex[idx]] = idx;
+    return result;
+}();
+
+// The dual maps each coefficient to a single coefficient of the complementary grade, up to its sign.
+// These are garamon's dualPermutations and dualCoefficients, flattened over the dense layout and
+// turned into a gather : dual[i] = denseDualSigns[i] * mv[denseDualSources[i]].
+namespace detail {
+constexpr unsigned int dualPermutations[denseSize] = {0, 0,3,2,1,4, 3,1,0,6,5,4,9,2,8,7, 2,1,7,0,5,4,3,9,8,6, 0,3,2,1,4, 0};
+constexpr int dualCoefficients[denseSize] = { 1, -1,-1, 1,-1,-1, -1, 1,-1,-1, 1,-1,-1,-1, 1,-1,
+                                              1,-1, 1, 1, 1,-1, 1, 1,-1, 1,  1, 1,-1, 1, 1, -1};
+} // namespace detail
+
+constexpr std::array<unsigned int, denseSize> denseDualSources = []() {
+    std::array<unsigned int, denseSize> result{};
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+        for (unsigned int i=0 ; i < binomialArray[grade] ; ++i)
+        {
+            const unsigned int source = perGradeStartingIndex[grade] + i;
+            result[perGradeStartingIndex[algebraDimension - grade] + detail::dualPermutations[source]] = source;
+        }
+    return result;
+}();
+
+constexpr std::array<int, denseSize> denseDualSigns = []() {
+    std::array<int, denseSize> result{};
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+        for (unsigned int i=0 ; i < binomialArray[grade] ; ++i)
+        {
+            const unsigned int permuted = detail::dualPermutations[perGradeStartingIndex[grade] + i];
+            result[perGradeStartingIndex[algebraDimension - grade] + permuted] = detail::dualCoefficients[perGradeStartingIndex[grade] + permuted];
+        }
+    return result;
+}();
+
+// The grade k block of a multivector becomes the grade (5 - k) block of its dual
+constexpr uint32_t dualGradeBitmap(const uint32_t& bitmap)
+{
+    uint32_t result = 0;
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+        if (bitmap & (1 << grade))
+            result |= 1 << (algebraDimension - grade);
+    return result;
+}
+
+
+// A multivector holding all its coefficients inline.
+// Unlike Mvec, it never allocates which makes it suitable for large contiguous arrays.
+// The grade bitmap follows the same convention as Mvec : the bit i is set if the
+// grade i block is part of the multivector (even if all its coefficients are zero).
+template <typename T>
+class DenseMvec
+{
+public:
+    DenseMvec() : m_coeffs{}, m_gradeBitmap(0) {}
+    DenseMvec(const Mvec<T>& mv);
+    // Conversion from another scalar type, e.g. to store objects as float
+    template <typename U>
+    explicit DenseMvec(const DenseMvec<U>& other);
+
+    Mvec<T> ToMvec() const;
+
+    inline T& operator[](const int idx)
+    {
+        m_gradeBitmap |= 1 << xorIndexToGrade[idx];
+        return m_coeffs[xorIndexToDenseIndex[idx]];
+    }
+    inline const T& operator[](const int idx) const { return m_coeffs[xorIndexToDenseIndex[idx]]; }
+
+    inline T* data() { return m_coeffs.data(); }
+    inline const T* data() const { return m_coeffs.data(); }
+    inline T* gradeData(const unsigned int grade) { return m_coeffs.data() + perGradeStartingIndex[grade]; }
+    inline const T* gradeData(const unsigned int grade) const { return m_coeffs.data() + perGradeStartingIndex[grade]; }
+
+    inline uint32_t gradeBitmap() const { return m_gradeBitmap; }
+    inline void setGradeBitmap(const uint32_t& bitmap) { m_gradeBitmap = bitmap; }
+
+    inline bool isEmpty() const { return m_gradeBitmap == 0; }
+    inline bool isGrade(const unsigned int grade) const { return m_gradeBitmap & (1 << grade); }
+    inline bool isHomogeneous() const { return (m_gradeBitmap & (m_gradeBitmap - 1)) == 0; }
+    // Returns the highest grade of the multivector, like Mvec::grade()
+    int grade() const;
+
+    void clear();
+    // Same as Mvec::roundZero() : zeroes the coefficients not greater than epsilon and drops the blocks left empty
+    void roundZero(const T& epsilon=std::numeric_limits<T>::epsilon());
+    DenseMvec<T> dual() const;
+    void dualize();
+    DenseMvec<T> reverse() const;
+
+    // Linear operations, the blocks of both operands being kept like with Mvec
+    DenseMvec<T>& operator+=(const DenseMvec<T>& other);
+    DenseMvec<T>& operator-=(const DenseMvec<T>& other);
+    DenseMvec<T>& operator*=(const T& value);
+    DenseMvec<T>& operator/=(const T& value);
+
+    bool operator==(const DenseMvec<T>& other) const;
+    inline bool operator!=(const DenseMvec<T>& other) const { return !(*this == other); }
+
+private:
+    std::array<T, denseSize> m_coeffs;
+    uint32_t m_gradeBitmap;
+};
+
+// The stride between two consecutive objects must be a whole number of coefficients
+// so that arrays of DenseMvec can be mapped as plain coefficient matrices.
+static_assert(sizeof(DenseMvec<double>) % sizeof(double) == 0);
+static_assert(sizeof(DenseMvec<float>) % sizeof(float) == 0);
+
+
+template <typename T>
+DenseMvec<T>::DenseMvec(const Mvec<T>& mv) : m_coeffs{}, m_gradeBitmap(0)
+{
+    if (mv.isEmpty())
+        return;
+
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+    {
+        if (!mv.isGrade(grade))
+            continue;
+
+        const auto& kvec = mv.findGrade(grade)->vec;
+        T* block = gradeData(grade);
+        for (unsigned int i=0 ; i < binomialArray[grade] ; ++i)
+            block[i] = kvec.coeff(i);
+
+        m_gradeBitmap |= 1 << grade;
+    }
+}
+
+template <typename T>
+template <typename U>
+DenseMvec<T>::DenseMvec(const DenseMvec<U>& other) : m_gradeBitmap(other.gradeBitmap())
+{
+    const U* coeffs = other.data();
+    for (unsigned int i=0 ; i < denseSize ; ++i)
+        m_coeffs[i] = T(coeffs[i]);
+}
+
+template <typename T>
+Mvec<T> DenseMvec<T>::ToMvec() const
+{
+    Mvec<T> result;
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+    {
+        if (!isGrade(grade))
+            continue;
+
+        const T* block = gradeData(grade);
+        for (unsigned int i=0 ; i < binomialArray[grade] ; ++i)
+            result.at(grade, i) = block[i];
+    }
+
+    return result;
+}
+
+template <typename T>
+int DenseMvec<T>::grade() const
+{
+    for (int grade=algebraDimension ; grade > 0 ; --grade)
+        if (isGrade(grade))
+            return grade;
+
+    return 0;
+}
+
+template <typename T>
+void DenseMvec<T>::clear()
+{
+    m_coeffs.fill(T(0));
+    m_gradeBitmap = 0;
+}
+
+template <typename T>
+void DenseMvec<T>::roundZero(const T& epsilon)
+{
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+    {
+        if (!isGrade(grade))
+            continue;
+
+        T* block = gradeData(grade);
+        bool empty = true;
+        for (unsigned int i=0 ; i < binomialArray[grade] ; ++i)
+        {
+            if (std::abs(block[i]) <= epsilon)
+                block[i] = T(0);
+            else
+                empty = false;
+        }
+
+        if (empty)
+            m_gradeBitmap &= ~(1 << grade);
+    }
+}
+
+template <typename T>
+DenseMvec<T> DenseMvec<T>::dual() const
+{
+    DenseMvec<T> result;
+    for (unsigned int i=0 ; i < denseSize ; ++i)
+        result.m_coeffs[i] = T(denseDualSigns[i]) * m_coeffs[denseDualSources[i]];
+    result.m_gradeBitmap = dualGradeBitmap(m_gradeBitmap);
+    return result;
+}
+
+template <typename T>
+void DenseMvec<T>::dualize()
+{
+    const std::array<T, denseSize> coeffs = m_coeffs;
+    for (unsigned int i=0 ; i < denseSize ; ++i)
+        m_coeffs[i] = T(denseDualSigns[i]) * coeffs[denseDualSources[i]];
+    m_gradeBitmap = dualGradeBitmap(m_gradeBitmap);
+}
+
+template <typename T>
+DenseMvec<T> DenseMvec<T>::reverse() const
+{
+    DenseMvec<T> result = *this;
+    for (unsigned int grade=0 ; grade <= algebraDimension ; ++grade)
+    {
+        if (signReversePerGrade[grade] > 0 || !isGrade(grade))
+            continue;
+
+        T* block = result.gradeData(grade);
+        for (unsigned int i=0 ; i < binomialArray[grade] ; ++i)
+            block[i] = -block[i];
+    }
+    return result;
+}
+
+template <typename T>
+DenseMvec<T>& DenseMvec<T>::operator+=(const DenseMvec<T>& other)
+{
+    for (unsigned int i=0 ; i < denseSize ; ++i)
+        m_coeffs[i] += other.m_coeffs[i];
+    m_gradeBitmap |= other.m_gradeBitmap;
+    return *this;
+}
+
+template <typename T>
+DenseMvec<T>& DenseMvec<T>::operator-=(const DenseMvec<T>& other)
+{
+    for (unsigned int i=0 ; i < denseSize ; ++i)
+        m_coeffs[i] -= other.m_coeffs[i];
+    m_gradeBitmap |= other.m_gradeBitmap;
+    return *this;
+}
+
+template <typename T>
+DenseMvec<T>& DenseMvec<T>::operator*=(const T& value)
+{
+    for (T& coeff : m_coeffs)
+        coeff *= value;
+    return *this;
+}
+
+template <typename T>
+DenseMvec<T>& DenseMvec<T>::operator/=(const T& value)
+{
+    for (T& coeff : m_coeffs)
+        coeff /= value;
+    return *this;
+}
+
+template <typename T>
+inline DenseMvec<T> operator+(DenseMvec<T> lhs, const DenseMvec<T>& rhs) { return lhs += rhs; }
+
+template <typename T>
+inline DenseMvec<T> operator-(DenseMvec<T> lhs, const DenseMvec<T>& rhs) { return lhs -= rhs; }
+
+template <typename T>
+inline DenseMvec<T> operator*(DenseMvec<T> mv, const T& value) { return mv *= value; }
+
+template <typename T>
+inline DenseMvec<T> operator*(const T& value, DenseMvec<T> mv) { return mv *= value; }
+
+template <typename T>
+inline DenseMvec<T> operator/(DenseMvec<T> mv, const T& value) { return mv /= value; }
+
+// Dualizes <count> contiguous objects
+template <typename T>
+void dualizeInPlace(DenseMvec<T>* objects, const size_t& count)
+{
+    for (size_t n=0 ; n < count ; ++n)
+        objects[n].dualize();
+}
+
+template <typename T>
+bool DenseMvec<T>::operator==(const DenseMvec<T>& other) const
+{
+    return m_gradeBitmap == other.m_gradeBitmap && m_coeffs == other.m_coeffs;
+}
+
+
+} // namespace c3ga
+
+
+#endif // DENSEMVEC_HPP
@@ -2,10 +2,14 @@
 #include "Provider.hpp"
 
 #include "Base/Logging.h"
+#include "Base/TypeUtils.h"
 
 #include <c3gaTools.hpp>
 #include <C3GAUtils.hpp>
+#include <C3GAClassify.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <random>
 
 
@@ -22,24 +26,98 @@ uint32_t GetNextUUID()
     return lastLayerUUID;
 }
 
+// == Versions ==
+
+// Layers are updated concurrently by LayerStack::Evaluate()
+static std::atomic<uint64_t> lastLayerVersion{0};
+
+static uint64_t GetNextVersion()
+{
+    return ++lastLayerVersion;
+}
+
+// == Objects ==
+
+void DualizeInPlace(MvecArray& objects)
+{
+    c3ga::dualizeInPlace(objects.data(), objects.size());
+}
+
+void DualizeInPlace(MvecTypeArray& types)
+{
+    for (auto& type : types)
+        type = c3ga::dualType(type);
+}
+
+// Conversion between the storage precisions
+template <typename T, typename U>
+static void ConvertObjects(const std::vector<c3ga::DenseMvec<U>>& objects, std::vector<c3ga::DenseMvec<T>>& result)
+{
+    result.resize(objects.size());
+    for (size_t n=0 ; n < objects.size() ; ++n)
+        result[n] = c3ga::DenseMvec<T>(objects[n]);
+}
+
+void ClassifyBatch(Span<const c3ga::DenseMvec<double>> objects, Span<c3ga::MvecType> types)
+{
+    c3ga::classifyBatch(objects.data(), objects.size(), types.data());
+}
+
+static size_t GetStoredCount(const LayerStorage& storage)
+{
+    if (storage.isPacked)
+        return storage.precision == LayerPrecision_Float ? storage.packedFloatObjects.size() : storage.packedObjects.size();
+
+    return storage.precision == LayerPrecision_Float ? storage.floatObjects.size() : storage.objects.size();
+}
+
+static void GetStoredObject(const LayerStorage& storage, const size_t& idx, c3ga::DenseMvec<double>& result)
+{
+    if (storage.isPacked && storage.precision == LayerPrecision_Float)
+        storage.packedFloatObjects.get(idx, result);
+    else if (storage.isPacked)
+        storage.packedObjects.get(idx, result);
+    else if (storage.precision == LayerPrecision_Float)
+        result = c3ga::DenseMvec<double>(storage.floatObjects[idx]);
+    else
+        result = storage.objects[idx];
+}
+
+// Copies the objects [offset, offset + count) of storage into result, replaced by their dual when dual is set
+static void GetStoredObjects(const LayerStorage& storage, const size_t& offset, const size_t& count, 
+                             const bool& dual, MvecArray& result)
+{
+    result.resize(count);
+    for (size_t n=0 ; n < count ; ++n)
+        GetStoredObject(storage, offset + n, result[n]);
+
+    if (dual)
+        DualizeInPlace(result);
+}
+
 // == Layer ==
 
 Layer::Layer(const std::string& name, 
              const MvecArray& objects) :
         m_name(name), 
         m_uuid(GetNextUUID()),
+        m_version(GetNextVersion()),
         m_objects(objects), 
+        m_storage(std::make_shared<LayerStorage>()),
         m_isDual(false), 
         m_visibility(true), 
         m_provider(new Explicit())
 {
-
+    ClassifyObjects();
+    StoreObjects();
 }
 
 Layer::Layer(const std::string& name, 
              const ProviderPtr& provider) :
         m_name(name), 
         m_uuid(GetNextUUID()),
+        m_version(GetNextVersion()),
+        m_storage(std::make_shared<LayerStorage>()),
         m_isDual(false), 
         m_visibility(true), 
         m_provider(provider) 
@@ -47,6 +125,278 @@ Layer::Layer(const std::string& name,
 
 }
 
+// Dense double objects are read as they are, unless they are viewed in part or dualized
+const MvecArray& Layer::GetObjects(MvecArray& storage) const
+{
+    const LayerStorage& stored = GetStorage();
+    const size_t count = GetObjectCount();
+    if (!stored.isPacked && stored.precision == LayerPrecision_Double && 
+        count == stored.objects.size() && !m_view.dual)
+        return stored.objects;
+
+    GetStoredObjects(stored, m_view.offset, count, m_view.dual, storage);
+    return storage;
+}
+
+const PackedMvecArray* Layer::GetPackedObjects(PackedMvecArray& storage) const
+{
+    const LayerStorage& stored = GetStorage();
+    if (!stored.isPacked)
+        return nullptr;
+
+    const size_t count = GetObjectCount();
+    if (stored.precision == LayerPrecision_Double && count == stored.packedObjects.size() && !m_view.dual)
+        return &stored.packedObjects;
+
+    if (stored.precision == LayerPrecision_Float)
+        storage.assign(stored.packedFloatObjects, m_view.offset, count);
+    else
+        storage.assign(stored.packedObjects, m_view.offset, count);
+    if (m_view.dual)
+        storage.dualize();
+
+    return &storage;
+}
+
+void Layer::SetObjects(const MvecArray& objects)
+{
+    m_view = LayerView();
+    m_objects = objects;
+    ClassifyObjects();
+    StoreObjects();
+    m_version = GetNextVersion();
+    SetDirty(DirtyBits_Provider);
+}
+
+size_t Layer::GetObjectCount() const
+{
+    return m_view.storage ? m_view.count : GetStoredCount(*m_storage);
+}
+
+c3ga::DenseMvec<double> Layer::GetObject(const uint32_t& idx) const
+{
+    c3ga::DenseMvec<double> result;
+    GetStoredObject(GetStorage(), m_view.offset + idx, result);
+    if (m_view.dual)
+        result.dualize();
+
+    return result;
+}
+
+bool Layer::SetView(const Layer& source, const size_t& offset, const size_t& count, const bool& dual)
+{
+    if ((dual && source.m_view.dual) || offset + count > source.GetObjectCount())
+        return false;
+
+    // Views over a view read the storage it views
+    LayerView view;
+    view.storage = source.m_view.storage ? source.m_view.storage : source.m_storage;
+    view.offset = source.m_view.offset + offset;
+    view.count = count;
+    view.dual = source.m_view.dual || dual;
+
+    MvecArray().swap(m_objects);
+    DetachStorage(false);
+    m_view = std::move(view);
+
+    return true;
+}
+
+// Single object edits write the storage in place, packed layers are only unpacked when the object doesn't have
+// their grade. Dense storages of packed layers are packed again once the layer is updated. Views are copied,
+// the edit only applying to the layer.
+void Layer::SetObject(const uint32_t& idx, const c3ga::DenseMvec<double>& object)
+{
+    LayerStorage& stored = DetachStorage(true);
+    const bool isFloat = stored.precision == LayerPrecision_Float;
+    if (IsView() || (stored.isPacked && !(isFloat ? stored.packedFloatObjects.set(idx, object) : 
+                                                    stored.packedObjects.set(idx, object))))
+    {
+        LoadObjects();
+        m_objects[idx] = object;
+        StoreObjects();
+    }
+    else if (!stored.isPacked && isFloat)
+        stored.floatObjects[idx] = c3ga::DenseMvec<float>(object);
+    else if (!stored.isPacked)
+        stored.objects[idx] = object;
+    m_types[idx] = c3ga::getTypeOf(object);
+    m_isNormalized = false;
+    m_version = GetNextVersion();
+}
+
+void Layer::AddObject(const c3ga::DenseMvec<double>& object)
+{
+    LayerStorage& stored = DetachStorage(true);
+    const bool isFloat = stored.precision == LayerPrecision_Float;
+    if (IsView() || (stored.isPacked && !(isFloat ? stored.packedFloatObjects.push_back(object) : 
+                                                    stored.packedObjects.push_back(object))))
+    {
+        LoadObjects();
+        m_objects.push_back(object);
+        StoreObjects();
+    }
+    else if (!stored.isPacked && isFloat)
+        stored.floatObjects.emplace_back(object);
+    else if (!stored.isPacked)
+        stored.objects.push_back(object);
+    m_types.push_back(c3ga::getTypeOf(object));
+    m_isNormalized = false;
+    m_version = GetNextVersion();
+}
+
+void Layer::RemoveObject(const uint32_t& idx)
+{
+    LayerStorage& stored = DetachStorage(true);
+    const bool isFloat = stored.precision == LayerPrecision_Float;
+    if (IsView())
+    {
+        LoadObjects();
+        m_objects.erase(m_objects.begin() + idx);
+        StoreObjects();
+    }
+    else if (stored.isPacked && isFloat)
+        stored.packedFloatObjects.erase(idx);
+    else if (stored.isPacked)
+        stored.packedObjects.erase(idx);
+    else if (isFloat)
+        stored.floatObjects.erase(stored.floatObjects.begin() + idx);
+    else
+        stored.objects.erase(stored.objects.begin() + idx);
+    m_types.erase(m_types.begin() + idx);
+    m_version = GetNextVersion();
+}
+
+void Layer::Clear()
+{
+    m_objects.clear();
+    m_view = LayerView();
+    DetachStorage(false);
+    m_types.clear();
+    m_version = GetNextVersion();
+}
+
+void Layer::ClassifyObjects()
+{
+    MvecArray storage;
+    const MvecArray& objects = IsView() ? GetObjects(storage) : m_objects;
+    m_types.resize(objects.size());
+    ClassifyBatch(objects, m_types);
+}
+
+// == Storage ==
+
+void Layer::SetPrecision(const LayerPrecision& precision)
+{
+    if (m_precision == precision)
+        return;
+
+    // Rounding to float changes the objects
+    LoadObjects();
+    m_precision = precision;
+    StoreObjects();
+    m_version = GetNextVersion();
+    SetDirty(DirtyBits_Provider);
+}
+
+void Layer::SetLayout(const LayerLayout& layout)
+{
+    if (m_layout == layout)
+        return;
+
+    LoadObjects();
+    m_layout = layout;
+    StoreObjects();
+    SetDirty(DirtyBits_Provider);
+}
+
+// Brings the objects back to the dense double array, whatever they are stored with.
+// The storage is only copied when views or cached results share it.
+void Layer::LoadObjects()
+{
+    if (IsView())
+    {
+        GetStoredObjects(*m_view.storage, m_view.offset, m_view.count, m_view.dual, m_objects);
+        m_view = LayerView();
+        return;
+    }
+
+    LayerStorage& stored = *m_storage;
+    if (stored.isPacked || stored.precision == LayerPrecision_Float)
+        GetStoredObjects(stored, 0, GetStoredCount(stored), false, m_objects);
+    else if (m_storage.use_count() > 1)
+        m_objects = stored.objects;
+    else
+        m_objects.swap(stored.objects);
+
+    DetachStorage(false);
+}
+
+// Moves the objects of the dense double array to the storage of the layer precision and layout
+void Layer::StoreObjects()
+{
+    LayerStorage& stored = DetachStorage(false);
+    stored.precision = m_precision;
+    if (m_layout == LayerLayout_Packed)
+    {
+        stored.isPacked = m_precision == LayerPrecision_Float ? stored.packedFloatObjects.pack(m_objects.data(), m_objects.size()) :
+                                                                stored.packedObjects.pack(m_objects.data(), m_objects.size());
+        if (stored.isPacked)
+        {
+            MvecArray().swap(m_objects);
+            return;
+        }
+    }
+
+    if (m_precision == LayerPrecision_Float)
+    {
+        ConvertObjects(m_objects, stored.floatObjects);
+        MvecArray().swap(m_objects);
+    }
+    else
+        stored.objects.swap(m_objects);
+}
+
+LayerStorage& Layer::DetachStorage(const bool& keepObjects)
+{
+    if (m_storage.use_count() > 1)
+        m_storage = keepObjects ? std::make_shared<LayerStorage>(*m_storage) : std::make_shared<LayerStorage>();
+    else if (!keepObjects)
+        *m_storage = LayerStorage();
+
+    return *m_storage;
+}
+
+// The types are computed in double before the objects are rounded : classify a sample
+// of the rounded objects in float and warn when their type changed.
+void Layer::ValidatePrecision() const
+{
+    constexpr size_t sampleSize = 1024;
+
+    const size_t count = GetObjectCount();
+    if (count == 0 || m_types.size() != count || IsView())
+        return;
+
+    const size_t step = std::max(count / sampleSize, (size_t)1);
+    size_t sampled = 0, diverging = 0;
+    c3ga::DenseMvec<float> object;
+    for (size_t n=0 ; n < count ; n += step)
+    {
+        if (m_storage->isPacked)
+            m_storage->packedFloatObjects.get(n, object);
+        else
+            object = m_storage->floatObjects[n];
+
+        if (c3ga::getTypeOf(object) != m_types[n])
+            ++diverging;
+        ++sampled;
+    }
+
+    if (diverging)
+        LOG_WARNING("Layer \"%s\" : %zu of %zu sampled objects change type when stored as float", 
+                    m_name.c_str(), diverging, sampled);
+}
+
 LayerWeakPtrArray Layer::GetSources() const
 {
     return m_sources;
@@ -163,20 +513,21 @@ void Layer::RemoveDestination(const LayerWeakPtr& layer)
     }
 }
 
+// Destinations are marked as depending on dirty sources, the propagation stopping at the layers that already are
 void Layer::SetDirty(const DirtyBits& dirtyBits)
 {
-    bool propagate = (dirtyBits != DirtyBits_None) && !IsDirty();
-    m_dirtyBits = (DirtyBits)(m_dirtyBits | dirtyBits);
-    if (!propagate) 
+    if ((m_dirtyBits & dirtyBits) == dirtyBits) 
     {
         return;
     }
 
+    m_dirtyBits = (DirtyBits)(m_dirtyBits | dirtyBits);
+
     for (const auto& dest : m_destinations)
     {
         if (auto ptr = dest.lock())
         {
-            ptr->SetDirty(DirtyBits_Provider);
+            ptr->SetDirty(DirtyBits_Sources);
         }
     }
 }
@@ -199,6 +550,9 @@ void Layer::SetDual(const bool& dual)
     }
 }
 
+// Coefficients not greater than this are rounded to zero by the RoundZero epilogue
+static constexpr double roundZeroEpsilon = 1e-6;
+
 bool Layer::Update() 
 {
     if (m_dirtyBits == DirtyBits_None)
@@ -208,25 +562,171 @@ bool Layer::Update()
 
     if (!m_provider)
     {
-        m_objects.clear();
+        Clear();
+        m_dirtyBits = DirtyBits_None;
+        return true;
+    }
+
+    // Only marked dirty through its sources, none of which ended up changing
+    if (m_dirtyBits == DirtyBits_Sources && !m_provider->SourcesChanged(*this))
+    {
         m_dirtyBits = DirtyBits_None;
         return false;
     }
 
-    for (auto& sourcePtr : m_sources) {
-        auto source = sourcePtr.lock();
-        if (source)
-        {
-            source->Update();  
-        }
+    // Nothing to compute when the inputs are the ones of the current objects or of a cached result
+    InputKey inputKey;
+    size_t inputHash = 0;
+    const bool memoized = GetInputKey(inputKey, inputHash);
+    if (memoized && m_inputVersion == m_version && m_inputHash == inputHash && m_inputKey == inputKey)
+    {
+        m_provider->RecordSourceVersions(*this);
+        m_dirtyBits = DirtyBits_None;
+        return false;
+    }
+    if (memoized && RestoreResult(inputKey, inputHash))
+    {
+        m_provider->RecordSourceVersions(*this);
+        m_dirtyBits = DirtyBits_None;
+        return true;
     }
+    CacheResult();
+
+    // Providers work on dense doubles, the other layers are only stored once everything is computed.
+    // Views are dropped rather than copied when the provider doesn't read the previous objects.
+    if (IsView() && !m_provider->ReadsObjects())
+        m_view = LayerView();
+    else
+        LoadObjects();
 
     bool objectsChanged = m_provider->Compute(*this);
-    if ((objectsChanged && m_isDual) || m_dirtyBits & DirtyBits_Dual)
-        for (auto& obj : m_objects)
-            obj = obj.dual();
+    m_provider->RecordSourceVersions(*this);
+    bool typesInferred = objectsChanged && m_provider->InferTypes(*this);
+    bool dualized = (objectsChanged && m_isDual) || m_dirtyBits & DirtyBits_Dual;
+
+    // Views are dualized on read, they are only copied when their objects have to be modified
+    if (IsView() && ((dualized && m_view.dual) || m_provider->GetEpilogue() != c3ga::Epilogue_None))
+        LoadObjects();
+    if (dualized && IsView())
+        m_view.dual = true;
+    else if (dualized)
+        DualizeInPlace(m_objects);
+
+    // The epilogue of the provider runs on the final objects, rounding may change their types
+    bool droppedBlocks = false;
+    bool epilogueChanged = false;
+    if (objectsChanged || dualized || m_dirtyBits & DirtyBits_Provider)
+    {
+        const uint32_t epilogue = m_provider->GetEpilogue();
+        const bool wasNormalized = m_isNormalized;
+        m_isNormalized = epilogue & c3ga::Epilogue_Normalize;
+        epilogueChanged = epilogue != c3ga::Epilogue_None || m_isNormalized != wasNormalized;
+        if (epilogue != c3ga::Epilogue_None)
+            droppedBlocks = c3ga::applyEpilogue(epilogue, roundZeroEpsilon, m_objects.data(), m_objects.size());
+        typesInferred &= !droppedBlocks;
+    }
+
+    // Providers write the objects directly, only reclassify when they did without telling their types
+    if (typesInferred)
+    {
+        if (dualized)
+            DualizeInPlace(m_types);
+    }
+    else if (objectsChanged || dualized || droppedBlocks || 
+             m_types.size() != (IsView() ? m_view.count : m_objects.size()))
+    {
+        ClassifyObjects();
+    }
+
+    // Views keep the storage of the layer they view
+    if (!IsView())
+        StoreObjects();
+    if (m_precision == LayerPrecision_Float && m_validatePrecision)
+        ValidatePrecision();
+
+    // Edits of explicit objects already changed the version, a provider that didn't compute anything leaves it as is
+    const bool contentChanged = objectsChanged || dualized || epilogueChanged;
+    if (contentChanged)
+        m_version = GetNextVersion();
+
+    m_inputKey = std::move(inputKey);
+    m_inputHash = inputHash;
+    m_inputVersion = memoized ? m_version : 0;
 
     m_dirtyBits = DirtyBits_None;
 
+    return contentChanged;
+}
+
+
+// == Cache ==
+
+bool Layer::GetInputKey(InputKey& key, size_t& hash) const
+{
+    if (!m_provider->GetParameters(key))
+        return false;
+
+    // Versions tell the content of the sources apart, without reading their objects
+    for (size_t i=0 ; i < m_sources.size() ; ++i)
+    {
+        auto source = m_sources[i].lock();
+        AppendKey(key, source ? source->GetVersion() : (uint64_t)0);
+        AppendKey(key, (bool)m_dualSources[i]);
+    }
+    AppendKey(key, m_isDual);
+    AppendKey(key, (int)m_precision);
+    AppendKey(key, (int)m_layout);
+
+    hash = key.size();
+    for (const uint64_t& value : key)
+        HashCombine(hash, value);
+
+    return true;
+}
+
+void Layer::SetCacheSize(const uint32_t& cacheSize)
+{
+    m_cacheSize = cacheSize;
+    if (m_cache.size() > m_cacheSize)
+        m_cache.resize(m_cacheSize);
+}
+
+// Shares the stored objects, only when they were computed from known inputs. The layer
+// then stores its next objects in a new storage.
+void Layer::CacheResult()
+{
+    if (!m_cacheSize || m_inputVersion != m_version)
+        return;
+
+    m_cache.push_front({m_inputKey, m_inputHash, m_version, m_storage, m_view, m_types, m_isNormalized});
+    if (m_cache.size() > m_cacheSize)
+        m_cache.pop_back();
+}
+
+// The current objects take the place of the restored ones in the cache
+bool Layer::RestoreResult(const InputKey& inputKey, const size_t& inputHash)
+{
+    auto it = std::find_if(m_cache.begin(), m_cache.end(),
+        [&inputKey, &inputHash](const CachedResult& result)
+        {
+            return result.inputHash == inputHash && result.inputKey == inputKey;
+        }
+    );
+    if (it == m_cache.end())
+        return false;
+
+    CachedResult result = std::move(*it);
+    m_cache.erase(it);
+    CacheResult();
+
+    m_storage = std::move(result.storage);
+    m_view = std::move(result.view);
+    m_types = std::move(result.types);
+    m_isNormalized = result.isNormalized;
+    m_version = result.version;
+    m_inputKey = std::move(result.inputKey);
+    m_inputHash = inputHash;
+    m_inputVersion = m_version;
+
     return true;
 }
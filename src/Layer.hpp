@@ -1,13 +1,32 @@
 #ifndef LAYER_HPP
 #define LAYER_HPP
 
-#include <c3ga/Mvec.hpp>
+#include "DenseMvec.hpp"
+#include "C3GABatch.hpp"
+#include "C3GAUtils.hpp"
+
+#include "Base/Span.h"
 
 #include <vector>
+#include <list>
 #include <memory>
 #include <functional>
 
-using MvecArray = std::vector<c3ga::Mvec<double>>;
+using MvecArray = std::vector<c3ga::DenseMvec<double>>;
+using FloatMvecArray = std::vector<c3ga::DenseMvec<float>>;
+using PackedMvecArray = c3ga::PackedArray<double>;
+using PackedFloatMvecArray = c3ga::PackedArray<float>;
+using MvecTypeArray = std::vector<c3ga::MvecType>;
+// Exact inputs of a provider, see Provider::GetParameters()
+using InputKey = std::vector<uint64_t>;
+
+// Replaces each object by its dual, in place
+void DualizeInPlace(MvecArray& objects);
+// Replaces each type by the type of the dual objects, in place
+void DualizeInPlace(MvecTypeArray& types);
+
+// Writes the type of each object, types must have the size of objects
+void ClassifyBatch(Span<const c3ga::DenseMvec<double>> objects, Span<c3ga::MvecType> types);
 
 
 class Layer;
@@ -26,10 +45,54 @@ enum DirtyBits
 {
     DirtyBits_None = 0,
     DirtyBits_Dual = 1 << 0,
+    // Set by the sources marked dirty, the layer only recomputes when one of their versions actually changed
+    DirtyBits_Sources = 1 << 1,
     DirtyBits_Provider = 1 << 2,
 };
 
 
+// Precision the objects of a layer are stored with. Providers always compute in double,
+// float layers only convert their objects once they are computed, halving their memory.
+enum LayerPrecision
+{
+    LayerPrecision_Double = 0,
+    LayerPrecision_Float,
+};
+
+// Layout the objects of a layer are stored with. Packed layers whose objects all share a single grade
+// only store the coefficients of that grade, as columns. They fall back to the dense layout otherwise.
+enum LayerLayout
+{
+    LayerLayout_Dense = 0,
+    LayerLayout_Packed,
+};
+
+
+// Objects of a layer as stored once computed, in its precision and layout. A storage is never modified
+// once shared : the views and cached results holding it keep it, the layer storing its next objects in a new one.
+struct LayerStorage
+{
+    MvecArray objects;
+    FloatMvecArray floatObjects;
+    PackedMvecArray packedObjects;
+    PackedFloatMvecArray packedFloatObjects;
+    LayerPrecision precision = LayerPrecision_Double;
+    bool isPacked = false;
+};
+
+using LayerStoragePtr = std::shared_ptr<LayerStorage>;
+using LayerStorageConstPtr = std::shared_ptr<const LayerStorage>;
+
+// Objects [offset, offset + count) of a storage, replaced by their dual on read when dual is set
+struct LayerView
+{
+    LayerStorageConstPtr storage;
+    size_t offset = 0;
+    size_t count = 0;
+    bool dual = false;
+};
+
+
 class Layer
 {
 public:
@@ -40,13 +103,42 @@ public:
     inline std::string GetName() const { return m_name; }
     inline void SetName(const std::string& name) { m_name = name; }
     inline uint32_t GetUUID() const { return m_uuid; }
+    // Version of the content of the layer, a new one each time its objects change, except for the
+    // results restored from the cache that get their version back. Versions are never shared between
+    // layers, comparing them is enough to tell a change.
+    inline uint64_t GetVersion() const { return m_version; }
 
+    // Working array of the provider during Update(), empty once the objects are stored
     inline const MvecArray& GetObjects() const { return m_objects; }
     inline MvecArray& GetObjects() { return m_objects; }
-    inline void SetObjects(const MvecArray& objects) { m_objects = objects; SetDirty(DirtyBits_Provider); }
-    inline c3ga::Mvec<double>& operator[](const uint32_t& idx) { return m_objects[idx]; }
-    inline const c3ga::Mvec<double>& operator[](const uint32_t& idx) const { return m_objects[idx]; }
-    inline void Clear() { m_objects.clear(); }
+    // Objects of any layer, float, packed or viewed ones being unpacked into storage
+    const MvecArray& GetObjects(MvecArray& storage) const;
+    // Objects of float layers that are neither packed nor views
+    inline const FloatMvecArray& GetFloatObjects() const { return m_storage->floatObjects; }
+    // Columns of packed layers, float ones and views over a part of the columns or their dual being copied
+    // into storage. Returns nullptr when the layer isn't packed.
+    const PackedMvecArray* GetPackedObjects(PackedMvecArray& storage) const;
+    void SetObjects(const MvecArray& objects);
+    size_t GetObjectCount() const;
+    c3ga::DenseMvec<double> GetObject(const uint32_t& idx) const;
+    void Clear();
+
+    // Exposes the objects [offset, offset + count) of source, dualized on read when dual is set, without copying
+    // them : the layer shares the storage of source until its own objects change. Returns false when they
+    // can't be viewed, the dual of a dual view being the opposite of its objects.
+    bool SetView(const Layer& source, const size_t& offset, const size_t& count, const bool& dual);
+    // Whether the objects are a view over the storage of another layer
+    inline bool IsView() const { return (bool)m_view.storage; }
+
+    // Single object edits, keeping the object types up to date
+    void SetObject(const uint32_t& idx, const c3ga::DenseMvec<double>& object);
+    void AddObject(const c3ga::DenseMvec<double>& object);
+    void RemoveObject(const uint32_t& idx);
+
+    // Type of each object, updated whenever the objects change
+    inline const MvecTypeArray& GetTypes() const { return m_types; }
+    inline MvecTypeArray& GetTypes() { return m_types; }
+    inline c3ga::MvecType GetType(const uint32_t& idx) const { return m_types[idx]; }
 
     LayerWeakPtrArray GetSources() const;
     virtual void AddSource(const LayerWeakPtr& layer);
@@ -72,21 +164,71 @@ public:
     inline bool IsDual() const { return m_isDual; }
     void SetDual(const bool& dual);
 
-    bool Update();
+    inline LayerPrecision GetPrecision() const { return m_precision; }
+    void SetPrecision(const LayerPrecision& precision);
+    // When enabled, float layers check on a sample of their objects that rounding them to float keeps their type
+    inline bool GetValidatePrecision() const { return m_validatePrecision; }
+    inline void SetValidatePrecision(const bool& validate) { m_validatePrecision = validate; }
+
+    inline LayerLayout GetLayout() const { return m_layout; }
+    void SetLayout(const LayerLayout& layout);
+    // Whether the objects are currently packed, a packed layer holding several grades isn't
+    inline bool IsPacked() const { return GetStorage().isPacked; }
+
+    // Whether the provider normalized the objects, which the extractors can then read as they are
+    inline bool IsNormalized() const { return m_isNormalized; }
 
-    inline MvecArray::iterator begin()             { return m_objects.begin(); }
-    inline MvecArray::iterator end()               { return m_objects.end(); }
-    inline MvecArray::const_iterator begin() const { return m_objects.begin(); }
-    inline MvecArray::const_iterator end()   const { return m_objects.end(); }
+    // Amount of previous results kept and restored when the inputs of the provider come back to
+    // what they were, e.g. while scrubbing one of its parameters. 0 disables the cache.
+    inline uint32_t GetCacheSize() const { return m_cacheSize; }
+    void SetCacheSize(const uint32_t& cacheSize);
+
+    // Recomputes the objects of a dirty layer, its sources being expected to be up to date.
+    // LayerStack::Evaluate() updates the layers in that order. Returns whether the version changed.
+    bool Update();
 
     inline bool operator==(const Layer& other) { return true; }
 
 private:
     std::string m_name;
     uint32_t m_uuid;
+    uint64_t m_version;
     bool m_visibility;
 
+    void ClassifyObjects();
+    void LoadObjects();
+    void StoreObjects();
+    void ValidatePrecision() const;
+
+    // Storage the objects are read from, the one of the viewed layer for views
+    inline const LayerStorage& GetStorage() const { return m_view.storage ? *m_view.storage : *m_storage; }
+    // Storage of the layer about to be modified, a copy when it is shared, an empty one unless keepObjects is set
+    LayerStorage& DetachStorage(const bool& keepObjects);
+
+    // Everything the objects are computed from and its hash, false when the provider can't be memoized.
+    // Results are only reused when their key matches, the hash only speeds up the comparison.
+    bool GetInputKey(InputKey& key, size_t& hash) const;
+    void CacheResult();
+    bool RestoreResult(const InputKey& inputKey, const size_t& inputHash);
+
+    // Objects of a previous update as they were stored, and what they were computed from
+    struct CachedResult
+    {
+        InputKey inputKey;
+        size_t inputHash;
+        uint64_t version;
+        LayerStoragePtr storage;
+        LayerView view;
+        MvecTypeArray types;
+        bool isNormalized;
+    };
+
     MvecArray m_objects;
+    // Shared with the views over the layer and the cached results, never null
+    LayerStoragePtr m_storage;
+    // Objects of another layer exposed instead of the storage, the storage of the view is null otherwise
+    LayerView m_view;
+    MvecTypeArray m_types;
     ProviderPtr m_provider;
 
     LayerWeakPtrArray m_sources;
@@ -94,6 +236,18 @@ private:
     LayerWeakPtrArray m_destinations;
     DirtyBits m_dirtyBits = DirtyBits_Provider;
     bool m_isDual;
+    LayerPrecision m_precision = LayerPrecision_Double;
+    bool m_validatePrecision = false;
+    LayerLayout m_layout = LayerLayout_Packed;
+    bool m_isNormalized = false;
+
+    // Inputs the objects of version m_inputVersion were computed from, edits of the objects changing their version
+    InputKey m_inputKey;
+    size_t m_inputHash = 0;
+    uint64_t m_inputVersion = 0;
+    // Most recently used first
+    std::list<CachedResult> m_cache;
+    uint32_t m_cacheSize = 0;
 };
 
 
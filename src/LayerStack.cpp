@@ -1,6 +1,13 @@
 #include "LayerStack.hpp"
 
 #include "Base/Logging.h"
+#include "Base/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
 
 
 LayerPtr LayerStack::GetLayer(const uint32_t& index) const
@@ -106,7 +113,7 @@ LayerPtr LayerStack::NewSelfCombination(const std::string& name,
                                const LayerPtr& source, 
                                const uint32_t& dimension, 
                                const int& count,
-                               const Operator& op)
+                               const OperatorConstPtr& op)
 {
     ProviderPtr provider = std::make_shared<SelfCombination>(dimension, count, op);
     LayerPtr layer = std::make_shared<Layer>(GetNextAvailableName(name), provider);
@@ -120,7 +127,7 @@ LayerPtr LayerStack::NewSelfCombination(const std::string& name,
 LayerPtr LayerStack::NewCombination(const std::string& name,
                                     const LayerPtr& source1,
                                     const LayerPtr& source2,
-                                    const Operator& op)
+                                    const OperatorConstPtr& op)
 {
     ProviderPtr combination = std::make_shared<Combination>(op);
     LayerPtr layer = std::make_shared<Layer>(GetNextAvailableName(name), combination);
@@ -133,11 +140,68 @@ LayerPtr LayerStack::NewCombination(const std::string& name,
     return layer;
 }
 
-void LayerStack::ConnectLayers(const LayerPtr& source, const LayerPtr& destination) const
+LayerPtr LayerStack::NewTransform(const std::string& name,
+                                  const LayerPtr& source)
+{
+    ProviderPtr provider = std::make_shared<Transform>();
+    LayerPtr layer = std::make_shared<Layer>(GetNextAvailableName(name), provider);
+    layer->AddSource(source);
+    source->AddDestination(layer);
+    m_layers.push_back(layer);
+
+    return layer;
+}
+
+LayerPtr LayerStack::NewPairwiseDistance(const std::string& name,
+                                         const LayerPtr& source1,
+                                         const LayerPtr& source2,
+                                         const DistanceMeasure& measure,
+                                         const uint32_t& nearestCount)
 {
+    ProviderPtr provider = std::make_shared<PairwiseDistance>(measure, nearestCount);
+    LayerPtr layer = std::make_shared<Layer>(GetNextAvailableName(name), provider);
+    layer->AddSource(source1);
+    layer->AddSource(source2);
+    source1->AddDestination(layer);
+    source2->AddDestination(layer);
+    m_layers.push_back(layer);
+
+    return layer;
+}
+
+// Whether target is layer or one of the layers computed from it
+static bool IsDownstream(const LayerPtr& layer, const LayerPtr& target, std::unordered_set<const Layer*>& visited)
+{
+    if (layer == target)
+        return true;
+    if (!visited.insert(layer.get()).second)
+        return false;
+
+    for (const auto& dst : layer->GetDestinations())
+    {
+        auto destination = dst.lock();
+        if (destination && IsDownstream(destination, target, visited))
+            return true;
+    }
+
+    return false;
+}
+
+bool LayerStack::ConnectLayers(const LayerPtr& source, const LayerPtr& destination) const
+{
+    std::unordered_set<const Layer*> visited;
+    if (source && IsDownstream(destination, source, visited))
+    {
+        LOG_WARNING("Cannot use \"%s\" as a source of \"%s\" : it depends on it",
+                    source->GetName().c_str(), destination->GetName().c_str());
+        return false;
+    }
+
     destination->AddSource(source);
     if (source)
         source->AddDestination(destination);
+
+    return true;
 }
 
 void LayerStack::DisconnectLayers(const LayerPtr& source, const LayerPtr& destination) const
@@ -147,6 +211,118 @@ void LayerStack::DisconnectLayers(const LayerPtr& source, const LayerPtr& destin
         source->RemoveDestination(destination);
 }
 
+bool LayerStack::Evaluate()
+{
+    auto isDirty = [](const LayerPtr& layer) { return layer->IsDirty(); };
+    if (std::none_of(m_layers.begin(), m_layers.end(), isDirty))
+        return false;
+
+    const LayerPtrArray layers = SortLayers();
+
+    // Walking the layers backwards, the sources of the required layers are required as well
+    std::unordered_set<const Layer*> required;
+    LayerPtrArray updated;
+    for (auto it = layers.rbegin() ; it != layers.rend() ; ++it)
+    {
+        const LayerPtr& layer = *it;
+        if (!layer->IsVisible() && required.find(layer.get()) == required.end())
+            continue;
+
+        required.insert(layer.get());
+        for (const auto& src : layer->GetSources())
+            if (auto source = src.lock())
+                required.insert(source.get());
+
+        if (layer->IsDirty())
+            updated.push_back(layer);
+    }
+    std::reverse(updated.begin(), updated.end());
+
+    if (m_evaluationMode == EvaluationMode_Parallel && updated.size() > 1 && 
+        ThreadPool::IsInitialized() && ThreadPool::Get().GetThreadCount())
+    {
+        return EvaluateParallel(updated);
+    }
+
+    bool somethingChanged = false;
+    for (const auto& layer : updated)
+        somethingChanged |= layer->Update();
+
+    return somethingChanged;
+}
+
+// Each layer is queued once all of its sources that have to be updated are
+bool LayerStack::EvaluateParallel(const LayerPtrArray& layers) const
+{
+    std::unordered_map<const Layer*, size_t> indices;
+    for (size_t i=0 ; i < layers.size() ; ++i)
+        indices[layers[i].get()] = i;
+
+    std::vector<std::atomic<uint32_t>> waitingSources(layers.size());
+    std::vector<std::vector<size_t>> destinations(layers.size());
+    for (size_t i=0 ; i < layers.size() ; ++i)
+    {
+        for (const auto& src : layers[i]->GetSources())
+        {
+            auto it = indices.find(src.lock().get());
+            if (it == indices.end())
+                continue;
+
+            ++waitingSources[i];
+            destinations[it->second].push_back(i);
+        }
+    }
+
+    std::atomic<bool> somethingChanged{false};
+    TaskGroup group(ThreadPool::Get());
+    std::function<void(const size_t&)> update = [&](const size_t& i)
+    {
+        if (layers[i]->Update())
+            somethingChanged = true;
+
+        for (const size_t& destination : destinations[i])
+            if (--waitingSources[destination] == 0)
+                group.Run([&update, destination]() { update(destination); });
+    };
+
+    // The layers ready from the start are listed before any runs, which would make others ready
+    std::vector<size_t> ready;
+    for (size_t i=0 ; i < layers.size() ; ++i)
+        if (waitingSources[i] == 0)
+            ready.push_back(i);
+
+    for (const size_t& i : ready)
+        group.Run([&update, i]() { update(i); });
+    group.Wait();
+
+    return somethingChanged;
+}
+
+LayerPtrArray LayerStack::SortLayers() const
+{
+    LayerPtrArray sorted;
+    sorted.reserve(m_layers.size());
+
+    // Depth first, each layer being added once all its sources are
+    std::unordered_set<const Layer*> visited;
+    std::function<void(const LayerPtr&)> visit = [&](const LayerPtr& layer)
+    {
+        if (!visited.insert(layer.get()).second)
+            return;
+
+        for (const auto& src : layer->GetSources())
+            if (auto source = src.lock())
+                visit(source);
+
+        sorted.push_back(layer);
+    };
+
+    for (const auto& layer : m_layers)
+        visit(layer);
+
+    return sorted;
+}
+
 std::string LayerStack::GetNextAvailableName(std::string basename) const
 {
     auto alreadyExists = [&](const std::string& n)->bool {
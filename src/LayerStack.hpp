@@ -10,6 +10,15 @@ class LayerStack;
 using LayerStackPtr = std::shared_ptr<LayerStack>;
 
 
+enum EvaluationMode
+{
+    // Layers are updated one after the other on the calling thread, always in the same order
+    EvaluationMode_Serial = 0,
+    // Layers whose sources are up to date are updated concurrently on the ThreadPool
+    EvaluationMode_Parallel,
+};
+
+
 class LayerStack
 {
 public:
@@ -35,19 +44,37 @@ public:
                        const LayerPtr& source, 
                        const uint32_t& dimension=2, 
                        const int& count=-1,
-                       const Operator& op=Operators::OuterProduct);
+                       const OperatorConstPtr& op=Operators::OuterProduct);
     LayerPtr NewCombination(const std::string& name,
                             const LayerPtr& source1,
                             const LayerPtr& source2,
-                            const Operator& op=Operators::OuterProduct);
+                            const OperatorConstPtr& op=Operators::OuterProduct);
+    LayerPtr NewTransform(const std::string& name,
+                          const LayerPtr& source);
+    LayerPtr NewPairwiseDistance(const std::string& name,
+                                 const LayerPtr& source1,
+                                 const LayerPtr& source2,
+                                 const DistanceMeasure& measure=DistanceMeasure_Distance,
+                                 const uint32_t& nearestCount=0);
 
-    void ConnectLayers(const LayerPtr& source, const LayerPtr& destination) const;
+    // Returns false and leaves the layers untouched when the connection would create a cycle
+    bool ConnectLayers(const LayerPtr& source, const LayerPtr& destination) const;
     void DisconnectLayers(const LayerPtr& source, const LayerPtr& destination) const;
 
+    // Updates the dirty layers that are visible or that a visible layer depends on,
+    // each one once and after its sources. Returns whether the version of a layer changed.
+    bool Evaluate();
+    inline EvaluationMode GetEvaluationMode() const { return m_evaluationMode; }
+    inline void SetEvaluationMode(const EvaluationMode& mode) { m_evaluationMode = mode; }
+
 private:
     std::string GetNextAvailableName(std::string basename="Layer") const;
+    // Layers ordered so that each one comes after its sources
+    LayerPtrArray SortLayers() const;
+    bool EvaluateParallel(const LayerPtrArray& layers) const;
     
     LayerPtrArray m_layers;
+    EvaluationMode m_evaluationMode = EvaluationMode_Parallel;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "Operator.hpp"
+
+#include "C3GABatch.hpp"
+
+
+// == Operator ==
+
+uint32_t Operator::GetResultGrades(const uint32_t&, const uint32_t&) const
+{
+    // Nothing is known about custom operators
+    return (1 << (c3ga::algebraDimension + 1)) - 1;
+}
+
+c3ga::TypeInference Operator::InferResultType(const c3ga::TypeInference&, const c3ga::TypeInference&) const
+{
+    return c3ga::TypeInference();
+}
+
+c3ga::TypeInference Operator::InferResultTypeWithEi(const c3ga::TypeInference&) const
+{
+    return c3ga::TypeInference();
+}
+
+void Operator::Apply(Span<const c3ga::DenseMvec<double>> lhs,
+                     Span<const c3ga::DenseMvec<double>> rhs,
+                     Span<c3ga::DenseMvec<double>> result) const
+{
+    const bool broadcastRhs = rhs.size() == 1;
+    for (size_t n=0 ; n < lhs.size() ; ++n)
+        result[n] = (*this)(lhs[n], broadcastRhs ? rhs[0] : rhs[n]);
+}
+
+void Operator::ApplyPairwise(Span<const c3ga::DenseMvec<double>> lhs,
+                             Span<const c3ga::DenseMvec<double>> rhs,
+                             const c3ga::DenseMvec<double>* trailing,
+                             Span<c3ga::DenseMvec<double>> result) const
+{
+    size_t n = 0;
+    for (const auto& obj1 : lhs)
+    {
+        for (const auto& obj2 : rhs)
+        {
+            result[n] = (*this)(obj1, obj2);
+            if (trailing)
+                result[n] = (*this)(result[n], *trailing);
+            ++n;
+        }
+    }
+}
+
+void Operator::ApplyPairwise(Span<const c3ga::DenseMvec<double>> lhs,
+                             const c3ga::PackedArray<double>& rhs,
+                             const c3ga::DenseMvec<double>* trailing,
+                             Span<c3ga::DenseMvec<double>> result) const
+{
+    std::vector<c3ga::DenseMvec<double>> rhsObjects(rhs.size());
+    rhs.unpack(rhsObjects.data());
+    ApplyPairwise(lhs, rhsObjects, trailing, result);
+}
+
+
+// == ProductOperator ==
+
+c3ga::DenseMvec<double> ProductOperator::operator()(const c3ga::DenseMvec<double>& lhs,
+                                                    const c3ga::DenseMvec<double>& rhs) const
+{
+    switch (m_product)
+    {
+        case c3ga::Product::Outer: return lhs ^ rhs;
+        case c3ga::Product::Inner: return lhs | rhs;
+        case c3ga::Product::Geometric: return lhs * rhs;
+    }
+
+    return {};
+}
+
+uint32_t ProductOperator::GetResultGrades(const uint32_t& lhsGrades, const uint32_t& rhsGrades) const
+{
+    uint32_t grades = 0;
+    for (unsigned int lhsGrade=0 ; lhsGrade <= c3ga::algebraDimension ; ++lhsGrade)
+    {
+        if (!(lhsGrades & (1 << lhsGrade)))
+            continue;
+
+        for (unsigned int rhsGrade=0 ; rhsGrade <= c3ga::algebraDimension ; ++rhsGrade)
+            if (rhsGrades & (1 << rhsGrade))
+                grades |= c3ga::productGrades(m_product, lhsGrade, rhsGrade);
+    }
+
+    return grades;
+}
+
+c3ga::TypeInference ProductOperator::InferResultType(const c3ga::TypeInference& lhs, const c3ga::TypeInference& rhs) const
+{
+    return c3ga::inferProductType(m_product, lhs, rhs);
+}
+
+c3ga::TypeInference ProductOperator::InferResultTypeWithEi(const c3ga::TypeInference& mv) const
+{
+    return c3ga::inferProductWithEiType(m_product, mv);
+}
+
+void ProductOperator::Apply(Span<const c3ga::DenseMvec<double>> lhs,
+                            Span<const c3ga::DenseMvec<double>> rhs,
+                            Span<c3ga::DenseMvec<double>> result) const
+{
+    const bool broadcastRhs = rhs.size() == 1 && lhs.size() != 1;
+    if (!c3ga::elementwiseProduct(m_product, lhs.data(), rhs.data(), lhs.size(), broadcastRhs, result.data()))
+        Operator::Apply(lhs, rhs, result);
+}
+
+void ProductOperator::ApplyPairwise(Span<const c3ga::DenseMvec<double>> lhs,
+                                    Span<const c3ga::DenseMvec<double>> rhs,
+                                    const c3ga::DenseMvec<double>* trailing,
+                                    Span<c3ga::DenseMvec<double>> result) const
+{
+    if (!c3ga::pairwiseProduct(m_product, lhs.data(), lhs.size(), rhs.data(), rhs.size(), trailing, result.data()))
+        Operator::ApplyPairwise(lhs, rhs, trailing, result);
+}
+
+void ProductOperator::ApplyPairwise(Span<const c3ga::DenseMvec<double>> lhs,
+                                    const c3ga::PackedArray<double>& rhs,
+                                    const c3ga::DenseMvec<double>* trailing,
+                                    Span<c3ga::DenseMvec<double>> result) const
+{
+    if (!c3ga::pairwiseProduct(m_product, lhs.data(), lhs.size(), rhs, trailing, result.data()))
+        Operator::ApplyPairwise(lhs, rhs, trailing, result);
+}
+
+
+namespace Operators {
+    const OperatorConstPtr InnerProduct = std::make_shared<ProductOperator>(c3ga::Product::Inner);
+    const OperatorConstPtr OuterProduct = std::make_shared<ProductOperator>(c3ga::Product::Outer);
+    const OperatorConstPtr GeomProduct = std::make_shared<ProductOperator>(c3ga::Product::Geometric);
+}
@@ -0,0 +1,99 @@
+#ifndef OPERATOR_HPP
+#define OPERATOR_HPP
+
+#include "C3GAProducts.hpp"
+#include "C3GAClassify.hpp"
+
+#include "Base/Foundations.h"
+#include "Base/Span.h"
+
+namespace c3ga {
+template <typename T>
+class PackedArray;
+}
+
+
+// A binary operation between multivectors, applied to whole arrays of objects at once.
+// Subclasses must at least implement the single pair operator(), the batched methods
+// fall back to calling it on each pair.
+class Operator
+{
+public:
+    virtual ~Operator() = default;
+
+    // Reference implementation, on a single pair of objects
+    virtual c3ga::DenseMvec<double> operator()(const c3ga::DenseMvec<double>& lhs,
+                                               const c3ga::DenseMvec<double>& rhs) const = 0;
+
+    // Bitmap of the grades the result can have, for operands of the given grade bitmaps
+    virtual uint32_t GetResultGrades(const uint32_t& lhsGrades, const uint32_t& rhsGrades) const;
+
+    // Type of the result for operands of the given types, Unknown when it can't be told without computing it
+    virtual c3ga::TypeInference InferResultType(const c3ga::TypeInference& lhs, const c3ga::TypeInference& rhs) const;
+    // Same for (mv op ei)
+    virtual c3ga::TypeInference InferResultTypeWithEi(const c3ga::TypeInference& mv) const;
+
+    // result[n] = lhs[n] op rhs[n]. If rhs holds a single object, it is used for every n.
+    // The result must have the size of lhs and may alias it.
+    virtual void Apply(Span<const c3ga::DenseMvec<double>> lhs,
+                       Span<const c3ga::DenseMvec<double>> rhs,
+                       Span<c3ga::DenseMvec<double>> result) const;
+
+    // result[i * rhs.size() + j] = lhs[i] op rhs[j], then op trailing if it is not null.
+    // The result must have the size lhs.size() * rhs.size() and must not alias the operands.
+    virtual void ApplyPairwise(Span<const c3ga::DenseMvec<double>> lhs,
+                               Span<const c3ga::DenseMvec<double>> rhs,
+                               const c3ga::DenseMvec<double>* trailing,
+                               Span<c3ga::DenseMvec<double>> result) const;
+    // Same, with the rhs objects stored packed
+    virtual void ApplyPairwise(Span<const c3ga::DenseMvec<double>> lhs,
+                               const c3ga::PackedArray<double>& rhs,
+                               const c3ga::DenseMvec<double>* trailing,
+                               Span<c3ga::DenseMvec<double>> result) const;
+};
+
+DECLARE_CONST_PTR_TYPE(Operator);
+
+
+// The products of the algebra, batched with the SIMD kernels when the operands are grade-homogeneous
+class ProductOperator : public Operator
+{
+public:
+    ProductOperator(const c3ga::Product& product) : m_product(product) {}
+
+    inline c3ga::Product GetProduct() const { return m_product; }
+
+    c3ga::DenseMvec<double> operator()(const c3ga::DenseMvec<double>& lhs,
+                                       const c3ga::DenseMvec<double>& rhs) const override;
+
+    uint32_t GetResultGrades(const uint32_t& lhsGrades, const uint32_t& rhsGrades) const override;
+
+    c3ga::TypeInference InferResultType(const c3ga::TypeInference& lhs, const c3ga::TypeInference& rhs) const override;
+    c3ga::TypeInference InferResultTypeWithEi(const c3ga::TypeInference& mv) const override;
+
+    void Apply(Span<const c3ga::DenseMvec<double>> lhs,
+               Span<const c3ga::DenseMvec<double>> rhs,
+               Span<c3ga::DenseMvec<double>> result) const override;
+
+    void ApplyPairwise(Span<const c3ga::DenseMvec<double>> lhs,
+                       Span<const c3ga::DenseMvec<double>> rhs,
+                       const c3ga::DenseMvec<double>* trailing,
+                       Span<c3ga::DenseMvec<double>> result) const override;
+    void ApplyPairwise(Span<const c3ga::DenseMvec<double>> lhs,
+                       const c3ga::PackedArray<double>& rhs,
+                       const c3ga::DenseMvec<double>* trailing,
+                       Span<c3ga::DenseMvec<double>> result) const override;
+
+private:
+    c3ga::Product m_product;
+};
+
+
+namespace Operators {
+    extern const OperatorConstPtr InnerProduct;
+    extern const OperatorConstPtr OuterProduct;
+    extern const OperatorConstPtr GeomProduct;
+}
+
+
+#endif // OPERATOR_HPP
@@ -2,11 +2,53 @@
 
 #include "Simulation.hpp"
 #include "Base/Logging.h"
+#include "Base/ThreadPool.h"
+#include "Base/TypeUtils.h"
 
 #include "c3gaTools.hpp"
+#include "C3GAClassify.hpp"
+#include "C3GAIntersect.hpp"
 
 #include <random>
 
+// == Provider ==
+
+// Expired sources count as version 0, which no layer has
+static uint64_t SourceVersion(const LayerWeakPtr& source)
+{
+    auto sourcePtr = source.lock();
+    return sourcePtr ? sourcePtr->GetVersion() : 0;
+}
+
+bool Provider::SourcesChanged(const Layer& layer) const
+{
+    const auto sources = layer.GetSources();
+    if (sources.size() != m_sourceVersions.size())
+        return true;
+
+    for (size_t i=0 ; i < sources.size() ; ++i)
+        if (SourceVersion(sources[i]) != m_sourceVersions[i])
+            return true;
+
+    return false;
+}
+
+void Provider::RecordSourceVersions(const Layer& layer)
+{
+    const auto sources = layer.GetSources();
+    m_sourceVersions.resize(sources.size());
+    for (size_t i=0 ; i < sources.size() ; ++i)
+        m_sourceVersions[i] = SourceVersion(sources[i]);
+}
+
+bool Provider::GetParameters(InputKey& key) const
+{
+    AppendKey(key, (int)GetType());
+    AppendKey(key, m_epilogue);
+    return true;
+}
+
+
 // == Explicit Provider ==
 
 void Explicit::SetAnimated(const bool& animated) {
@@ -16,12 +58,15 @@ void Explicit::SetAnimated(const bool& animated) {
     {
         engine.RemoveSimulation(m_simHandle);
         m_simHandle = SimulationHandle();
+        m_epilogue &= ~c3ga::Epilogue_RoundZero;
         return;
     }
 
     if (animated && !m_simHandle.IsValid())
     {
         m_simHandle = engine.NewSimulation();
+        // Rounding to make sure precision issues of the simulation don't mess up the rest of the program
+        m_epilogue |= c3ga::Epilogue_RoundZero;
     }
 }
 
@@ -41,15 +86,14 @@ bool Explicit::Compute(Layer& layer)
         // if the layer store them as dual. 
         if (layer.IsDual())
         {
-            MvecArray duals(objects.size());
-            for (size_t i=0 ; i < objects.size() ; ++i)
-                duals[i] = objects[i].dual();
+            MvecArray duals = objects;
+            DualizeInPlace(duals);
 
-            m_simHandle.SetObjects(duals);
+            m_simHandle.SetObjects(duals, m_generator);
         }
         else 
         {
-            m_simHandle.SetObjects(objects);
+            m_simHandle.SetObjects(objects, m_generator);
         }
     }
     else 
@@ -65,8 +109,15 @@ bool Explicit::Compute(Layer& layer)
 
 bool RandomGenerator::Compute(Layer& layer) 
 {
+    const bool regenerated = m_isDirty;
     if (m_isDirty)
     {
+        auto randomPoint = [this]()
+        {
+            std::uniform_real_distribution<double> distrib(-1.0, 1.0);
+            return c3ga::point<double>(distrib(m_generator), distrib(m_generator), distrib(m_generator));
+        };
+
         auto& objects = layer.GetObjects();
         objects.clear();
         switch (m_objType)
@@ -76,9 +127,9 @@ bool RandomGenerator::Compute(Layer& layer)
                 for (size_t i=0 ; i < m_count ; ++i)
                 {
                     std::uniform_real_distribution<double> distrib(-m_extents, m_extents);
-                    objects.push_back(c3ga::point<double>(distrib(c3ga::generator),
-                                                          distrib(c3ga::generator), 
-                                                          distrib(c3ga::generator)));
+                    objects.push_back(c3ga::point<double>(distrib(m_generator),
+                                                          distrib(m_generator), 
+                                                          distrib(m_generator)));
                 }
                     
                 break;
@@ -88,9 +139,9 @@ bool RandomGenerator::Compute(Layer& layer)
                 for (size_t i=0 ; i < m_count ; ++i)
                 {
 		            std::uniform_real_distribution<double> distrib(-m_extents, m_extents);
-                    objects.push_back(c3ga::dualSphere<double>(distrib(c3ga::generator),
-                                                               distrib(c3ga::generator), 
-                                                               distrib(c3ga::generator), 
+                    objects.push_back(c3ga::dualSphere<double>(distrib(m_generator),
+                                                               distrib(m_generator), 
+                                                               distrib(m_generator), 
                                                                1.0).dual());
                 }
 
@@ -101,9 +152,9 @@ bool RandomGenerator::Compute(Layer& layer)
                 for (size_t i=0 ; i < m_count ; ++i)
                 {
 		            std::uniform_real_distribution<double> distrib(-m_extents, m_extents);
-                    objects.push_back(c3ga::dualSphere<double>(distrib(c3ga::generator),
-                                                               distrib(c3ga::generator), 
-                                                               distrib(c3ga::generator), 
+                    objects.push_back(c3ga::dualSphere<double>(distrib(m_generator),
+                                                               distrib(m_generator), 
+                                                               distrib(m_generator), 
                                                                1.0));
                 }
 
@@ -112,30 +163,30 @@ bool RandomGenerator::Compute(Layer& layer)
             case c3ga::MvecType::Plane:
             {
                 for (size_t i=0 ; i < m_count ; ++i)
-                    objects.push_back(c3ga::dualPlane<double>(c3ga::randomVector<double>() * m_extents).dual());
+                    objects.push_back(c3ga::dualPlane<double>(c3ga::randomVector<double>(m_generator) * m_extents).dual());
 
                 break;
             }
             case c3ga::MvecType::DualPlane:
             {
                 for (size_t i=0 ; i < m_count ; ++i)
-                    objects.push_back(c3ga::dualPlane<double>(c3ga::randomVector<double>() * m_extents));
+                    objects.push_back(c3ga::dualPlane<double>(c3ga::randomVector<double>(m_generator) * m_extents));
 
                 break;
             }
             case c3ga::MvecType::PairPoint:
             {
                 for (size_t i=0 ; i < m_count ; ++i)
-                    objects.push_back(c3ga::randomPoint<double>() * m_extents ^ 
-                                      c3ga::randomPoint<double>() * m_extents);
+                    objects.push_back(randomPoint() * m_extents ^ 
+                                      randomPoint() * m_extents);
 
                 break;
             }
             case c3ga::MvecType::DualPairPoint:
             {
                 for (size_t i=0 ; i < m_count ; ++i)
-                    objects.push_back((c3ga::randomPoint<double>() * m_extents ^ 
-                                       c3ga::randomPoint<double>() * m_extents).dual());
+                    objects.push_back((randomPoint() * m_extents ^ 
+                                       randomPoint() * m_extents).dual());
 
                 break;
             }
@@ -143,15 +194,21 @@ bool RandomGenerator::Compute(Layer& layer)
 
         if (IsAnimated())
         {
-            m_simHandle.SetObjects({});
+            m_simHandle.SetObjects({}, m_generator);
         }
 
         m_isDirty = false;
     }
 
-    return Explicit::Compute(layer);
+    return Explicit::Compute(layer) || regenerated;
 }
 
+// Minimum amount of objects processed per task by the providers, copying or dualizing one object
+// being cheap. The providers evaluating products split their work in chunks of at least productGrainSize pairs.
+static constexpr size_t objectGrainSize = 1024;
+static constexpr size_t productGrainSize = 4096;
+
+
 // == Subset ==
 
 bool Subset::Compute(Layer& layer)
@@ -164,25 +221,101 @@ bool Subset::Compute(Layer& layer)
     }
 
     const auto source = sources[0].lock();
-    const auto& sourceObjs = source->GetObjects();
     const bool sourceIsDual = layer.SourceIsDual(0);
+    const size_t sourceCount = source->GetObjectCount();
+
+    uint32_t count = m_count < 0 ? sourceCount : std::min((size_t)m_count, sourceCount);
+
+    // The subset shares the storage of the source, dualized on read
+    if (layer.SetView(*source, 0, count, sourceIsDual))
+        return true;
 
-    uint32_t count = m_count < 0 ? sourceObjs.size() : std::min((size_t)m_count, sourceObjs.size());
+    // Only the dual of a dual view is copied, its objects being unpacked
+    PackedMvecArray packedStorage;
+    MvecArray sourceStorage;
+    const auto packedObjs = source->GetPackedObjects(packedStorage);
+    const MvecArray& sourceObjs = packedObjs ? sourceStorage : source->GetObjects(sourceStorage);
 
     auto& objects = layer.GetObjects();
     objects.resize(count);
-    if (sourceIsDual)
-        for (size_t i=0 ; i < count ; ++i)
-            objects[i] = sourceObjs[i].dual();
-    else
-        for (size_t i=0 ; i < count ; ++i)
-            objects[i] = sourceObjs[i];
+    ParallelFor(count, objectGrainSize, [&](size_t begin, size_t end)
+    {
+        for (size_t n=begin ; n < end ; ++n)
+        {
+            if (packedObjs)
+                packedObjs->get(n, objects[n]);
+            else
+                objects[n] = sourceObjs[n];
+
+            if (sourceIsDual)
+                objects[n].dualize();
+        }
+    });
+
+    return true;
+}
+
+bool Subset::InferTypes(Layer& layer) const
+{
+    auto sources = layer.GetSources();
+    if (sources.empty())
+        return false;
+
+    const auto source = sources[0].lock();
+    const auto& sourceTypes = source->GetTypes();
+    const size_t count = layer.IsView() ? layer.GetObjectCount() : layer.GetObjects().size();
+    if (sourceTypes.size() < count)
+        return false;
+
+    auto& types = layer.GetTypes();
+    types.assign(sourceTypes.begin(), sourceTypes.begin() + count);
+    if (layer.SourceIsDual(0))
+        DualizeInPlace(types);
+
+    return true;
+}
+
+bool Subset::GetParameters(InputKey& key) const
+{
+    Provider::GetParameters(key);
+    AppendKey(key, m_count);
+    return true;
+}
 
+// == Operator Based Provider ==
+
+bool OperatorBasedProvider::GetParameters(InputKey& key) const
+{
+    Provider::GetParameters(key);
+    AppendKey(key, m_op.get());
+    AppendKey(key, m_productWithEi);
     return true;
 }
 
 // == Self Combination ==
 
+static const c3ga::DenseMvec<double> ei = c3ga::ei<double>();
+
+static bool IsOuterProduct(const OperatorConstPtr& op)
+{
+    const auto product = std::dynamic_pointer_cast<const ProductOperator>(op);
+    return product && product->GetProduct() == c3ga::Product::Outer;
+}
+
+// Gathers the grade <grade> block of the objects of a source (or of their dual) as the columns of
+// a closed-form intersection operand, straight from its packed columns when it has some
+static void GatherOperand(const PackedMvecArray* packedObjs, const MvecArray& objects,
+                          const uint32_t* indices, const size_t& indexStride, 
+                          const size_t& count, const unsigned int& grade, const bool& dual, 
+                          std::vector<double>& columns)
+{
+    columns.resize(c3ga::binomialArray[grade] * count);
+    if (packedObjs)
+        c3ga::gatherBlocks(*packedObjs, indices, indexStride, count, grade, dual, columns.data());
+    else
+        c3ga::gatherBlocks(objects.data(), indices, indexStride, count, grade, dual, columns.data());
+}
+
 // Get all order independent combinations of integers.
 // This code is adapted from https://rosettacode.org/wiki/Combinations
 std::vector<std::vector<uint32_t>> GetIntegerCombinations(const uint32_t& maxIndex, const uint32_t& combinationSize)
@@ -217,8 +350,7 @@ bool SelfCombination::Compute(Layer& layer)
     }
 
     const auto source = sources[0].lock();
-    const auto& sourceObjs = source->GetObjects(); 
-    const uint32_t sourceObjCount = sourceObjs.size();
+    const uint32_t sourceObjCount = source->GetObjectCount();
     const bool sourceIsDual = layer.SourceIsDual(0);
 
     if (sourceObjCount < m_dimension)
@@ -237,10 +369,9 @@ bool SelfCombination::Compute(Layer& layer)
         m_prevProductWithEi != GetProductWithEi())
     {
         // Generate random samples
-        std::random_device device;
-        std::mt19937 engine(device());
+        std::mt19937 engine(m_seed);
 
-        auto combinations = GetIntegerCombinations(sourceObjs.size(), m_dimension);
+        auto combinations = GetIntegerCombinations(sourceObjCount, m_dimension);
         std::shuffle(combinations.begin(), combinations.end(), engine);
 
         outObjCount = m_count < 0 ? combinations.size() : std::min((size_t)m_count, combinations.size());
@@ -253,38 +384,48 @@ bool SelfCombination::Compute(Layer& layer)
         }
     }
 
-    // Apply operator for each count for each "dimension"
     result.resize(outObjCount);
-    uint idx = 0;
-    if (sourceIsDual)
+    const auto& sourceTypes = source->GetTypes();
+    const bool typesAreValid = sourceTypes.size() == sourceObjCount;
+
+    // The operands are gathered from the source columns when it is packed, and from its objects otherwise
+    PackedMvecArray packedStorage;
+    MvecArray sourceStorage;
+    const auto packedObjs = source->GetPackedObjects(packedStorage);
+    const MvecArray& sourceObjs = packedObjs ? sourceStorage : source->GetObjects(sourceStorage);
+
+    // Intersections of two spheres or planes (or of three points with ei) have a closed form,
+    // evaluated straight from the source without going through the generic products.
+    // Each chunk of the windows gathers its own operands.
+    if (typesAreValid && IsOuterProduct(op) && !GetProductWithEi() && m_dimension == 2 &&
+        c3ga::getIntersection(sourceTypes.data(), sourceObjCount, sourceIsDual,
+                              sourceTypes.data(), sourceObjCount, sourceIsDual) == c3ga::Intersection::VectorVector)
     {
-        for (auto& obj : result)
+        ParallelFor(outObjCount, objectGrainSize, [&](size_t begin, size_t end)
         {
-            obj = sourceObjs[m_indices[idx]].dual();
-            for (uint i=0 ; i < m_dimension - 1 ; ++i) {
-                ++idx;
-                obj = op(obj, sourceObjs[m_indices[idx]].dual());
-            }
-            ++idx;
-
-            if (GetProductWithEi())
-                obj = op(obj, c3ga::ei<double>());
-        }
+            const uint32_t* indices = m_indices.data() + begin * m_dimension;
+            std::vector<double> lhs, rhs;
+            GatherOperand(packedObjs, sourceObjs, indices, m_dimension, end - begin, 1, sourceIsDual, lhs);
+            GatherOperand(packedObjs, sourceObjs, indices + 1, m_dimension, end - begin, 1, sourceIsDual, rhs);
+            c3ga::elementwiseIntersection(c3ga::Intersection::VectorVector, lhs.data(), rhs.data(), end - begin, result.data() + begin);
+        });
     }
-    else
+    else if (typesAreValid && IsOuterProduct(op) && GetProductWithEi() && m_dimension == 3 &&
+             c3ga::areVectors(sourceTypes.data(), sourceObjCount, sourceIsDual))
     {
-        for (auto& obj : result)
+        ParallelFor(outObjCount, objectGrainSize, [&](size_t begin, size_t end)
         {
-            obj = sourceObjs[m_indices[idx]];
-            for (uint i=0 ; i < m_dimension - 1 ; ++i) {
-                ++idx;
-                obj = op(obj, sourceObjs[m_indices[idx]]);
-            }
-            ++idx;
-
-            if (GetProductWithEi())
-                obj = op(obj, c3ga::ei<double>());
-        }
+            const uint32_t* indices = m_indices.data() + begin * m_dimension;
+            std::vector<double> a, b, c;
+            GatherOperand(packedObjs, sourceObjs, indices, m_dimension, end - begin, 1, sourceIsDual, a);
+            GatherOperand(packedObjs, sourceObjs, indices + 1, m_dimension, end - begin, 1, sourceIsDual, b);
+            GatherOperand(packedObjs, sourceObjs, indices + 2, m_dimension, end - begin, 1, sourceIsDual, c);
+            c3ga::planesThroughPoints(a.data(), b.data(), c.data(), end - begin, result.data() + begin);
+        });
+    }
+    else
+    {
+        ComputeSteps(packedObjs, sourceObjs, sourceIsDual, *op, result);
     }
 
     m_prevCount = m_count;
@@ -295,8 +436,97 @@ bool SelfCombination::Compute(Layer& layer)
     return true;
 }
 
+void SelfCombination::ComputeSteps(const PackedMvecArray* packedObjs, const MvecArray& sourceObjs, 
+                                   const bool& sourceIsDual, const Operator& op, MvecArray& result) const
+{
+    // Apply operator for each count for each "dimension", one step for all the objects of a chunk at a time
+    ParallelFor(result.size(), objectGrainSize, [&](size_t begin, size_t end)
+    {
+        Span<c3ga::DenseMvec<double>> chunk = Span<c3ga::DenseMvec<double>>(result).subspan(begin, end - begin);
+        MvecArray operands(chunk.size());
+        for (uint step=0 ; step < m_dimension ; ++step)
+        {
+            Span<c3ga::DenseMvec<double>> stepObjs = step == 0 ? chunk : Span<c3ga::DenseMvec<double>>(operands);
+            for (size_t n=0 ; n < chunk.size() ; ++n)
+            {
+                const uint32_t index = m_indices[(begin + n) * m_dimension + step];
+                if (packedObjs)
+                    packedObjs->get(index, stepObjs[n]);
+                else
+                    stepObjs[n] = sourceObjs[index];
+
+                if (sourceIsDual)
+                    stepObjs[n].dualize();
+            }
+
+            if (step > 0)
+                op.Apply(chunk, operands, chunk);
+        }
+
+        if (GetProductWithEi())
+            op.Apply(chunk, ei, chunk);
+    });
+}
+
+bool SelfCombination::InferTypes(Layer& layer) const
+{
+    auto sources = layer.GetSources();
+    auto op = GetOperator();
+    const auto& objects = layer.GetObjects();
+    if (!op || sources.empty() || m_indices.size() != objects.size() * m_dimension)
+        return false;
+
+    const auto source = sources[0].lock();
+    const auto& sourceTypes = source->GetTypes();
+    const bool sourceIsDual = layer.SourceIsDual(0);
+    if (sourceTypes.size() != source->GetObjectCount())
+        return false;
+
+    auto sourceType = [&](const uint32_t& index) {
+        return sourceIsDual ? c3ga::dualType(sourceTypes[index]) : sourceTypes[index];
+    };
+
+    // Follow the types through the same steps as Compute(), only checking what couldn't be inferred
+    auto& types = layer.GetTypes();
+    types.resize(objects.size());
+    for (uint n=0 ; n < objects.size() ; ++n)
+    {
+        c3ga::TypeInference type = sourceType(m_indices[n * m_dimension]);
+        for (uint step=1 ; step < m_dimension ; ++step)
+            type = op->InferResultType(type, sourceType(m_indices[n * m_dimension + step]));
+        if (GetProductWithEi())
+            type = op->InferResultTypeWithEi(type);
+
+        types[n] = c3ga::getTypeOf(objects[n], type);
+    }
+
+    return true;
+}
+
+// The combinations are sampled from the seed of the provider, the same parameters always sample the same ones
+bool SelfCombination::GetParameters(InputKey& key) const
+{
+    OperatorBasedProvider::GetParameters(key);
+    AppendKey(key, m_count);
+    AppendKey(key, m_dimension);
+    return true;
+}
+
 // == Combination ==
 
+// Rows of a pairwise result per task, for rows of rowSize pairs
+static size_t RowGrainSize(const size_t& rowSize)
+{
+    return std::max((size_t)1, productGrainSize / std::max(rowSize, (size_t)1));
+}
+
+static const MvecArray& Dualize(const MvecArray& objects, MvecArray& result)
+{
+    result = objects;
+    DualizeInPlace(result);
+    return result;
+}
+
 bool Combination::Compute(Layer& layer) 
 {
     auto sources = layer.GetSources();
@@ -311,28 +541,447 @@ bool Combination::Compute(Layer& layer)
     LayerPtr sourcePtr1 = sources[0].lock();
     LayerPtr sourcePtr2 = sources[1].lock();
 
-    const auto& sourceObjs1 = sourcePtr1->GetObjects(); 
-    const auto& sourceObjs2 = sourcePtr2->GetObjects(); 
-
     const bool source1IsDual = layer.SourceIsDual(0);
     const bool source2IsDual = layer.SourceIsDual(1);
 
     auto& result = layer.GetObjects();
-    result.resize(sourceObjs1.size() * sourceObjs2.size());
+    const size_t count1 = sourcePtr1->GetObjectCount();
+    const size_t count2 = sourcePtr2->GetObjectCount();
+    result.resize(count1 * count2);
+
+    // Intersections of spheres, planes, circles and lines have a closed form, 
+    // evaluated straight from the sources without going through the generic products
+    const auto& sourceTypes1 = sourcePtr1->GetTypes();
+    const auto& sourceTypes2 = sourcePtr2->GetTypes();
+    if (IsOuterProduct(op) && !GetProductWithEi() && sourceTypes1.size() == count1 && sourceTypes2.size() == count2)
+    {
+        const auto intersection = c3ga::getIntersection(sourceTypes1.data(), count1, source1IsDual,
+                                                        sourceTypes2.data(), count2, source2IsDual);
+        if (intersection != c3ga::Intersection::None)
+        {
+            std::vector<double> lhs, rhs;
+            PackedMvecArray packedStorage1, packedStorage2;
+            MvecArray sourceStorage1, sourceStorage2;
+            const auto packedObjs1 = sourcePtr1->GetPackedObjects(packedStorage1);
+            const auto packedObjs2 = sourcePtr2->GetPackedObjects(packedStorage2);
+            const unsigned int lhsGrade = c3ga::intersectionLhsGrade(intersection);
+            GatherOperand(packedObjs1, packedObjs1 ? sourceStorage1 : sourcePtr1->GetObjects(sourceStorage1),
+                          nullptr, 0, count1, lhsGrade, source1IsDual, lhs);
+            GatherOperand(packedObjs2, packedObjs2 ? sourceStorage2 : sourcePtr2->GetObjects(sourceStorage2),
+                          nullptr, 0, count2, c3ga::intersectionRhsGrade(intersection), source2IsDual, rhs);
+
+            // Each chunk of rows copies its part of the lhs columns
+            ParallelFor(count1, RowGrainSize(count2), [&](size_t begin, size_t end)
+            {
+                std::vector<double> rows(c3ga::binomialArray[lhsGrade] * (end - begin));
+                for (unsigned int c=0 ; c < c3ga::binomialArray[lhsGrade] ; ++c)
+                    std::copy(lhs.begin() + c * count1 + begin, lhs.begin() + c * count1 + end, rows.begin() + c * (end - begin));
+
+                c3ga::pairwiseIntersection(intersection, rows.data(), end - begin, rhs.data(), count2, result.data() + begin * count2);
+            });
+
+            return true;
+        }
+    }
+
+    MvecArray sourceStorage1, sourceStorage2;
+    const auto& sourceObjs1 = sourcePtr1->GetObjects(sourceStorage1); 
+
+    MvecArray dualObjs1, dualObjs2;
+    const MvecArray& objs1 = source1IsDual ? Dualize(sourceObjs1, dualObjs1) : sourceObjs1;
+    const c3ga::DenseMvec<double>* trailing = GetProductWithEi() ? &ei : nullptr;
+
+    // Chunks of rows of the result are computed in parallel, each one from a chunk of the first source
+    auto applyPairwise = [&](const auto& objs2)
+    {
+        ParallelFor(count1, RowGrainSize(count2), [&](size_t begin, size_t end)
+        {
+            op->ApplyPairwise(Span<const c3ga::DenseMvec<double>>(objs1).subspan(begin, end - begin), 
+                              objs2, trailing, 
+                              Span<c3ga::DenseMvec<double>>(result).subspan(begin * count2, (end - begin) * count2));
+        });
+    };
+
+    // The products run over the columns of the second source when it is packed
+    PackedMvecArray packedStorage;
+    if (const auto packedObjs2 = sourcePtr2->GetPackedObjects(packedStorage))
+    {
+        if (source2IsDual)
+        {
+            if (packedObjs2 != &packedStorage)
+                packedStorage = *packedObjs2;
+            packedStorage.dualize();
+            applyPairwise(packedStorage);
+        }
+        else
+        {
+            applyPairwise(*packedObjs2);
+        }
+
+        return true;
+    }
+
+    const auto& sourceObjs2 = sourcePtr2->GetObjects(sourceStorage2); 
+    const MvecArray& objs2 = source2IsDual ? Dualize(sourceObjs2, dualObjs2) : sourceObjs2;
+    applyPairwise(objs2);
+
+    return true;
+}
+
+bool Combination::InferTypes(Layer& layer) const
+{
+    auto sources = layer.GetSources();
+    auto op = GetOperator();
+    if (sources.size() < 2 || !op)
+        return false;
+
+    LayerPtr sourcePtr1 = sources[0].lock();
+    LayerPtr sourcePtr2 = sources[1].lock();
 
-    uint i=0;
-    for (const auto& s1 : sourceObjs1)
+    const auto& sourceTypes1 = sourcePtr1->GetTypes();
+    const auto& sourceTypes2 = sourcePtr2->GetTypes();
+    const auto& objects = layer.GetObjects();
+    if (sourceTypes1.size() != sourcePtr1->GetObjectCount() ||
+        sourceTypes2.size() != sourcePtr2->GetObjectCount() ||
+        objects.size() != sourceTypes1.size() * sourceTypes2.size())
     {
-        for (const auto& s2 : sourceObjs2)
+        return false;
+    }
+
+    const bool source1IsDual = layer.SourceIsDual(0);
+    const bool source2IsDual = layer.SourceIsDual(1);
+
+    // There are only a few types, infer the result of each pair of them once
+    constexpr size_t typeCount = (size_t)c3ga::MvecType::NonHomogenousMultiVector + 1;
+    std::vector<c3ga::TypeInference> inferences(typeCount * typeCount);
+    for (size_t i=0 ; i < typeCount ; ++i)
+    {
+        const c3ga::MvecType type1 = (c3ga::MvecType)i;
+        for (size_t j=0 ; j < typeCount ; ++j)
         {
-            result[i] = op(source1IsDual ? s1.dual() : s1, 
-                           source2IsDual ? s2.dual() : s2);
+            const c3ga::MvecType type2 = (c3ga::MvecType)j;
+            c3ga::TypeInference& type = inferences[i * typeCount + j];
+            type = op->InferResultType(source1IsDual ? c3ga::dualType(type1) : type1,
+                                       source2IsDual ? c3ga::dualType(type2) : type2);
             if (GetProductWithEi())
-                result[i] = op(result[i], c3ga::ei<double>());
-            ++i;
+                type = op->InferResultTypeWithEi(type);
+        }
+    }
+
+    auto& types = layer.GetTypes();
+    types.resize(objects.size());
+    size_t n = 0;
+    for (const auto& type1 : sourceTypes1)
+    {
+        for (const auto& type2 : sourceTypes2)
+        {
+            types[n] = c3ga::getTypeOf(objects[n], inferences[(size_t)type1 * typeCount + (size_t)type2]);
+            ++n;
+        }
+    }
+
+    return true;
+}
+
+// == Transform ==
+
+c3ga::Versor<double> Transform::GetVersor() const
+{
+    // Rotation of m_angle around the axis : exp(-angle / 2 * plane), the plane being the dual of the axis
+    c3ga::DenseMvec<double> plane;
+    plane[c3ga::E23] = m_axis[0];
+    plane[c3ga::E13] = -m_axis[1];
+    plane[c3ga::E12] = m_axis[2];
+    const double axisNorm = std::sqrt(m_axis[0] * m_axis[0] + m_axis[1] * m_axis[1] + m_axis[2] * m_axis[2]);
+    c3ga::Versor<double> rotor;
+    if (axisNorm > 0.0)
+        rotor = c3ga::Versor<double>::fromBivector(plane * (-0.5 * m_angle * M_PI / 180.0 / axisNorm));
+
+    // Scaling from the origin : exp(log(scale) / 2 * e0i)
+    c3ga::DenseMvec<double> origin;
+    origin[c3ga::E0i] = 0.5 * std::log((double)m_scale);
+    const auto dilator = c3ga::Versor<double>::fromBivector(origin);
+
+    // Translation : exp(-translation ^ ei / 2)
+    c3ga::DenseMvec<double> direction;
+    direction[c3ga::E1i] = -0.5 * m_translation[0];
+    direction[c3ga::E2i] = -0.5 * m_translation[1];
+    direction[c3ga::E3i] = -0.5 * m_translation[2];
+    const auto translator = c3ga::Versor<double>::fromBivector(direction);
+
+    return translator * dilator * rotor;
+}
+
+bool Transform::Compute(Layer& layer)
+{
+    auto sources = layer.GetSources();
+    if (sources.empty())
+    {
+        layer.Clear();
+        return false;
+    }
+
+    if (m_isDirty)
+    {
+        m_matrix = c3ga::VersorMatrix<double>(GetVersor());
+        m_isDirty = false;
+    }
+
+    const auto source = sources[0].lock();
+    const bool sourceIsDual = layer.SourceIsDual(0);
+    auto& objects = layer.GetObjects();
+
+    // Packed sources are transformed with a single matrix product over their columns
+    PackedMvecArray packedStorage;
+    if (const auto packedObjs = source->GetPackedObjects(packedStorage))
+    {
+        PackedMvecArray transformed;
+        if (sourceIsDual)
+        {
+            transformed = *packedObjs;
+            transformed.dualize();
+            m_matrix.apply(transformed, transformed);
+        }
+        else
+        {
+            m_matrix.apply(*packedObjs, transformed);
+        }
+
+        objects.resize(transformed.size());
+        transformed.unpack(objects.data());
+        return true;
+    }
+
+    MvecArray sourceStorage;
+    objects = source->GetObjects(sourceStorage);
+    if (sourceIsDual)
+        DualizeInPlace(objects);
+    m_matrix.apply(objects.data(), objects.size(), objects.data());
+
+    return true;
+}
+
+bool Transform::InferTypes(Layer& layer) const
+{
+    auto sources = layer.GetSources();
+    if (sources.empty())
+        return false;
+
+    // Rotations, translations and positive scalings keep the type of the objects
+    const auto source = sources[0].lock();
+    const auto& sourceTypes = source->GetTypes();
+    if (sourceTypes.size() != layer.GetObjects().size())
+        return false;
+
+    auto& types = layer.GetTypes();
+    types = sourceTypes;
+    if (layer.SourceIsDual(0))
+        DualizeInPlace(types);
+
+    return true;
+}
+
+bool Transform::GetParameters(InputKey& key) const
+{
+    Provider::GetParameters(key);
+    for (unsigned int i=0 ; i < 3 ; ++i)
+    {
+        AppendKey(key, m_translation[i]);
+        AppendKey(key, m_axis[i]);
+    }
+    AppendKey(key, m_angle);
+    AppendKey(key, m_scale);
+    return true;
+}
+
+// == Pairwise Distance ==
+
+static bool IsPointOrDualSphere(const c3ga::MvecType& type)
+{
+    return type == c3ga::MvecType::Point || 
+           type == c3ga::MvecType::DualSphere || 
+           type == c3ga::MvecType::ImaginaryDualSphere;
+}
+
+// Objects of the source as packed vectors, dualized if needed.
+// Returns nullptr when they aren't all points or dual spheres, once dualized.
+static const PackedMvecArray* GetPackedVectors(const LayerPtr& source, const bool& dual, PackedMvecArray& storage)
+{
+    const auto& types = source->GetTypes();
+    const bool typesMatch = std::all_of(types.begin(), types.end(), [&dual](const c3ga::MvecType& type)
+    {
+        return IsPointOrDualSphere(dual ? c3ga::dualType(type) : type);
+    });
+    if (!typesMatch)
+        return nullptr;
+
+    const PackedMvecArray* packedObjs = source->GetPackedObjects(storage);
+    if (!packedObjs)
+    {
+        MvecArray objectsStorage;
+        const auto& objects = source->GetObjects(objectsStorage);
+        if (!storage.pack(objects.data(), objects.size()))
+            return nullptr;
+        packedObjs = &storage;
+    }
+
+    if (dual)
+    {
+        if (packedObjs != &storage)
+            storage = *packedObjs;
+        storage.dualize();
+        packedObjs = &storage;
+    }
+
+    return packedObjs->grade() == 1 ? packedObjs : nullptr;
+}
+
+bool PairwiseDistance::Compute(Layer& layer)
+{
+    auto sources = layer.GetSources();
+    m_nearestIndices.clear();
+    if (sources.size() < 2)
+    {
+        layer.Clear();
+        return false;
+    }
+
+    PackedMvecArray storage1, storage2;
+    const auto vectors1 = GetPackedVectors(sources[0].lock(), layer.SourceIsDual(0), storage1);
+    const auto vectors2 = GetPackedVectors(sources[1].lock(), layer.SourceIsDual(1), storage2);
+    if (!vectors1 || !vectors2)
+    {
+        LOG_WARNING("Layer \"%s\" : pairwise distances are only computed between points and dual spheres", 
+                    layer.GetName().c_str());
+        layer.Clear();
+        return false;
+    }
+
+    // Blocks of pairs small enough for their powers to stay in cache
+    constexpr size_t blockSize = 256;
+
+    const size_t count1 = vectors1->size();
+    const size_t count2 = vectors2->size();
+    const uint32_t nearestCount = std::min((size_t)m_nearestCount, count2);
+    std::vector<double> powers(blockSize * blockSize);
+    auto& result = layer.GetObjects();
+
+    if (!nearestCount)
+    {
+        result.resize(count1 * count2);
+        for (size_t start1=0 ; start1 < count1 ; start1 += blockSize)
+        {
+            const size_t size1 = std::min(blockSize, count1 - start1);
+            for (size_t start2=0 ; start2 < count2 ; start2 += blockSize)
+            {
+                const size_t size2 = std::min(blockSize, count2 - start2);
+                c3ga::vectorPowers(*vectors1, start1, size1, *vectors2, start2, size2, powers.data());
+
+                for (size_t i=0 ; i < size1 ; ++i)
+                {
+                    for (size_t j=0 ; j < size2 ; ++j)
+                    {
+                        // The power is negative for a point inside a sphere or two intersecting spheres, whose
+                        // distance is clamped to 0. The power measure keeps its sign to tell them apart.
+                        const double power = powers[i * size2 + j];
+                        auto& object = result[(start1 + i) * count2 + start2 + j];
+                        object.clear();
+                        object.gradeData(0)[0] = m_measure == DistanceMeasure_Power ? power : std::sqrt(std::max(power, 0.0));
+                        object.setGradeBitmap(1 << 0);
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // The distance grows with the power, the nearest objects are the ones of lowest power.
+    // Each object of a block of source1 keeps a max-heap of its nearest candidates.
+    using Candidate = std::pair<double, uint32_t>;
+    std::vector<std::vector<Candidate>> candidates(blockSize);
+    m_nearestIndices.resize(count1 * nearestCount);
+    for (size_t start1=0 ; start1 < count1 ; start1 += blockSize)
+    {
+        const size_t size1 = std::min(blockSize, count1 - start1);
+        for (auto& heap : candidates)
+            heap.clear();
+
+        for (size_t start2=0 ; start2 < count2 ; start2 += blockSize)
+        {
+            const size_t size2 = std::min(blockSize, count2 - start2);
+            c3ga::vectorPowers(*vectors1, start1, size1, *vectors2, start2, size2, powers.data());
+
+            for (size_t i=0 ; i < size1 ; ++i)
+            {
+                auto& heap = candidates[i];
+                for (size_t j=0 ; j < size2 ; ++j)
+                {
+                    const Candidate candidate(powers[i * size2 + j], start2 + j);
+                    if (heap.size() < nearestCount)
+                    {
+                        heap.push_back(candidate);
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                    else if (candidate < heap.front())
+                    {
+                        std::pop_heap(heap.begin(), heap.end());
+                        heap.back() = candidate;
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                }
+            }
         }
 
+        for (size_t i=0 ; i < size1 ; ++i)
+        {
+            std::sort_heap(candidates[i].begin(), candidates[i].end());
+            for (uint32_t k=0 ; k < nearestCount ; ++k)
+                m_nearestIndices[(start1 + i) * nearestCount + k] = candidates[i][k].second;
+        }
     }
 
+    result.resize(m_nearestIndices.size());
+    for (size_t n=0 ; n < result.size() ; ++n)
+        vectors2->get(m_nearestIndices[n], result[n]);
+
+    return true;
+}
+
+bool PairwiseDistance::InferTypes(Layer& layer) const
+{
+    auto sources = layer.GetSources();
+    const auto& objects = layer.GetObjects();
+    if (sources.size() < 2)
+        return false;
+
+    auto& types = layer.GetTypes();
+    if (m_nearestIndices.empty())
+    {
+        types.assign(objects.size(), c3ga::MvecType::Scalar);
+        return true;
+    }
+
+    const auto source2 = sources[1].lock();
+    const auto& sourceTypes = source2->GetTypes();
+    if (m_nearestIndices.size() != objects.size() || sourceTypes.size() != source2->GetObjectCount())
+        return false;
+
+    const bool sourceIsDual = layer.SourceIsDual(1);
+    types.resize(objects.size());
+    for (size_t n=0 ; n < objects.size() ; ++n)
+    {
+        const c3ga::MvecType type = sourceTypes[m_nearestIndices[n]];
+        types[n] = sourceIsDual ? c3ga::dualType(type) : type;
+    }
+
+    return true;
+}
+
+bool PairwiseDistance::GetParameters(InputKey& key) const
+{
+    Provider::GetParameters(key);
+    AppendKey(key, (int)m_measure);
+    AppendKey(key, m_nearestCount);
     return true;
 }
@@ -4,24 +4,12 @@
 #include "Layer.hpp"
 #include "Simulation.hpp"
 
+#include "Operator.hpp"
 #include "C3GAUtils.hpp"
+#include "C3GAVersor.hpp"
 
+#include <array>
 
-using Operator = c3ga::Mvec<double>(*)(const c3ga::Mvec<double>&, const c3ga::Mvec<double>&);
-
-namespace Operators {
-    inline c3ga::Mvec<double> 
-    InnerProduct(const c3ga::Mvec<double>& first, 
-                 const c3ga::Mvec<double>& second) { return first | second; }
-                 
-    inline c3ga::Mvec<double> 
-    OuterProduct(const c3ga::Mvec<double>& first, 
-                 const c3ga::Mvec<double>& second) { return first ^ second; }
-
-    inline c3ga::Mvec<double> 
-    GeomProduct(const c3ga::Mvec<double>& first, 
-                const c3ga::Mvec<double>& second) { return first * second; }
-}
 
 enum ProviderType
 {
@@ -30,29 +18,62 @@ enum ProviderType
     ProviderType_Subset,
     ProviderType_Combination,
     ProviderType_SelfCombination,
+    ProviderType_Transform,
+    ProviderType_PairwiseDistance,
 };
 
 class Provider
 {
 public:
     virtual bool Compute(Layer& layer) = 0;
+    // Writes the types of the objects of the last Compute() from the types of the sources,
+    // returns false when they can't be told and the objects must be classified instead.
+    virtual bool InferTypes(Layer&) const { return false; }
+    // Whether Compute() reads the objects the layer held before, views are only copied to its working array then
+    virtual bool ReadsObjects() const { return true; }
     virtual ProviderType GetType() const = 0;
     virtual inline uint32_t GetSourceCount() const { return 0; }
+
+    // Passes run by the layer over the objects once computed, a combination of c3ga::EpilogueBits
+    inline uint32_t GetEpilogue() const { return m_epilogue; }
+    inline void SetEpilogue(const uint32_t& epilogue) { m_epilogue = epilogue; }
+
+    // Versions of the sources of the layer the last Compute() read, so that it's only run
+    // again for sources marked dirty when one of them actually changed
+    bool SourcesChanged(const Layer& layer) const;
+    void RecordSourceVersions(const Layer& layer);
+
+    // Appends the type and the parameters Compute() depends on besides the sources to key. Returns false when
+    // the objects can't be told from them (explicit or random objects), the layer then never memoizes them.
+    virtual bool GetParameters(InputKey& key) const;
+
+protected:
+    uint32_t m_epilogue = c3ga::Epilogue_None;
+    std::vector<uint64_t> m_sourceVersions;
 };
 
 
 class Explicit : public Provider
 {
 public:
+    Explicit() : m_generator(c3ga::generator()) {}
+
     inline bool IsAnimated() const { return m_simHandle.IsValid(); }
     void SetAnimated(const bool& animated);
 
     bool Compute(Layer& layer) override;
+    // Explicit objects are the input themselves : they are edited in place, generated or simulated, and
+    // never memoized. Their layer only skips updates through its version, bumped by every edit.
+    inline bool GetParameters(InputKey&) const override { return false; }
     inline ProviderType GetType() const override { return ProviderType_Explicit; };
     inline uint32_t GetSourceCount() const override { return 0; }
 
 protected:
     SimulationHandle m_simHandle;
+
+    // Seeded from c3ga::generator on creation, so that the objects and their motion only depend on
+    // the order the providers are created in, not on the thread they are computed on
+    std::default_random_engine m_generator;
 };
 
 class RandomGenerator : public Explicit
@@ -100,6 +121,9 @@ public:
     inline void SetCount(const int& count) { m_count = count; }
 
     bool Compute(Layer& layer) override;
+    bool InferTypes(Layer& layer) const override;
+    inline bool ReadsObjects() const override { return false; }
+    bool GetParameters(InputKey& key) const override;
     inline ProviderType GetType() const override { return ProviderType_Subset; }
     inline uint32_t GetSourceCount() const override { return 1; }
 
@@ -111,16 +135,18 @@ private:
 class OperatorBasedProvider : public Provider
 {
 public:
-    OperatorBasedProvider(const Operator& op=Operators::OuterProduct) : m_op(op) {}
+    OperatorBasedProvider(const OperatorConstPtr& op=Operators::OuterProduct) : m_op(op) {}
 
-    inline Operator GetOperator() const { return m_op; }
-    inline void SetOperator(const Operator& op) { m_op = op; }
+    inline const OperatorConstPtr& GetOperator() const { return m_op; }
+    inline void SetOperator(const OperatorConstPtr& op) { m_op = op; }
 
     inline bool GetProductWithEi() const { return m_productWithEi; }
     inline void SetProductWithEi(const bool& productWithEi) { m_productWithEi = productWithEi; }
 
+    bool GetParameters(InputKey& key) const override;
+
 private:
-    Operator m_op;
+    OperatorConstPtr m_op;
     bool m_productWithEi = false;
 };
 
@@ -128,13 +154,14 @@ private:
 class SelfCombination : public OperatorBasedProvider
 {
 public:
-    SelfCombination() : OperatorBasedProvider(), m_dimension(0), m_count(-1) {}
+    SelfCombination() : OperatorBasedProvider(), m_dimension(0), m_count(-1), m_seed(c3ga::generator()) {}
     SelfCombination(const uint32_t& dimension, 
                     const int& count=-1,
-                    const Operator& op=Operators::OuterProduct) :
+                    const OperatorConstPtr& op=Operators::OuterProduct) :
             OperatorBasedProvider(op),
             m_dimension(dimension), 
-            m_count(count) {}
+            m_count(count),
+            m_seed(c3ga::generator()) {}
 
     inline int GetCount() const { return m_count; }
     inline void SetCount(const int& count) { m_count = count; }
@@ -143,13 +170,22 @@ public:
     inline void SetDimension(const uint8_t& dimension) { m_dimension = dimension; }
 
     bool Compute(Layer& layer) override;
+    bool InferTypes(Layer& layer) const override;
+    bool GetParameters(InputKey& key) const override;
     inline ProviderType GetType() const override { return ProviderType_SelfCombination; }
     inline uint32_t GetSourceCount() const override { return 1; }
 
 private:
+    // Generic evaluation, applying the operator to one more operand of all the combinations at a time
+    void ComputeSteps(const PackedMvecArray* packedObjs, const MvecArray& sourceObjs, 
+                      const bool& sourceIsDual, const Operator& op, MvecArray& result) const;
+
     int m_count;
     uint32_t m_dimension;
 
+    // Seed of the sampling of the combinations, taken from c3ga::generator on creation so that the same
+    // inputs always sample the same combinations, whatever the order the layers are evaluated in
+    uint32_t m_seed;
     std::vector<uint32_t> m_indices;
     int m_prevCount = 0;
     uint32_t m_prevDim = 0, m_prevSourceCount = 0;
@@ -160,12 +196,97 @@ private:
 class Combination : public OperatorBasedProvider
 {
 public:
-    Combination(const Operator& op=Operators::OuterProduct) : 
+    Combination(const OperatorConstPtr& op=Operators::OuterProduct) : 
             OperatorBasedProvider(op) {}
 
     bool Compute(Layer& layer) override;
+    bool InferTypes(Layer& layer) const override;
     inline ProviderType GetType() const override { return ProviderType_Combination; }
     inline uint32_t GetSourceCount() const override { return 2; }
 };
 
+
+// Moves all the objects of its source by the same versor : a rotation around an axis through the origin,
+// then a scaling from the origin, then a translation. The versor is compiled into a matrix once per change.
+class Transform : public Provider
+{
+public:
+    // Dilations change the weight of the objects, they are normalized back by default
+    Transform() : m_translation{0.0f, 0.0f, 0.0f}, m_axis{0.0f, 0.0f, 1.0f}, m_angle(0.0f), m_scale(1.0f) 
+    { 
+        m_epilogue = c3ga::Epilogue_Normalize; 
+    }
+
+    inline const std::array<float, 3>& GetTranslation() const { return m_translation; }
+    inline void SetTranslation(const std::array<float, 3>& translation) { m_translation = translation; m_isDirty = true; }
+
+    inline const std::array<float, 3>& GetAxis() const { return m_axis; }
+    inline void SetAxis(const std::array<float, 3>& axis) { m_axis = axis; m_isDirty = true; }
+
+    // In degrees
+    inline float GetAngle() const { return m_angle; }
+    inline void SetAngle(const float& angle) { m_angle = angle; m_isDirty = true; }
+
+    // Strictly positive, so that the types of the objects are kept
+    inline float GetScale() const { return m_scale; }
+    inline void SetScale(const float& scale) { m_scale = std::max(scale, 1e-3f); m_isDirty = true; }
+
+    c3ga::Versor<double> GetVersor() const;
+
+    bool Compute(Layer& layer) override;
+    bool InferTypes(Layer& layer) const override;
+    bool GetParameters(InputKey& key) const override;
+    inline ProviderType GetType() const override { return ProviderType_Transform; }
+    inline uint32_t GetSourceCount() const override { return 1; }
+
+private:
+    bool m_isDirty = true;
+    c3ga::VersorMatrix<double> m_matrix;
+
+    std::array<float, 3> m_translation;
+    std::array<float, 3> m_axis;
+    float m_angle;
+    float m_scale;
+};
+
+
+enum DistanceMeasure
+{
+    DistanceMeasure_Distance = 0,
+    DistanceMeasure_Power,
+};
+
+// Distances between the points and spheres of two layers, evaluated by blocks as matrix products of their
+// coefficients. Without a nearest count, the result holds the scalar distance or power of every pair,
+// source1[i] with source2[j] being at i * source2 count + j. Otherwise, it holds the nearest count objects
+// of source2 closest to each object of source1, nearest first. Both sources must only hold points and
+// dual spheres. Distances are 0 for the pairs of negative power, a point inside a sphere or intersecting
+// spheres, the power measure keeping its sign.
+class PairwiseDistance : public Provider
+{
+public:
+    PairwiseDistance(const DistanceMeasure& measure=DistanceMeasure_Distance, const uint32_t& nearestCount=0) :
+            m_measure(measure),
+            m_nearestCount(nearestCount) {}
+
+    inline DistanceMeasure GetMeasure() const { return m_measure; }
+    inline void SetMeasure(const DistanceMeasure& measure) { m_measure = measure; }
+
+    inline uint32_t GetNearestCount() const { return m_nearestCount; }
+    inline void SetNearestCount(const uint32_t& nearestCount) { m_nearestCount = nearestCount; }
+
+    bool Compute(Layer& layer) override;
+    bool InferTypes(Layer& layer) const override;
+    bool GetParameters(InputKey& key) const override;
+    inline ProviderType GetType() const override { return ProviderType_PairwiseDistance; }
+    inline uint32_t GetSourceCount() const override { return 2; }
+
+private:
+    DistanceMeasure m_measure;
+    uint32_t m_nearestCount;
+
+    // Source2 index of each object of the last Compute() with a nearest count
+    std::vector<uint32_t> m_nearestIndices;
+};
+
 #endif  // PROVIDER_HPP
\ No newline at end of file
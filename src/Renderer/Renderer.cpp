@@ -1,7 +1,8 @@
 #include "Renderer.hpp"
 #include "Shapes.hpp"
 
-#include "c3gaTools.hpp"
+#include "C3GABatch.hpp"
+#include "C3GAExtract.hpp"
 #include "C3GAUtils.hpp"
 
 #include "Base/Resolver.h"
@@ -73,7 +74,7 @@ void Renderer::Render(const LayerPtrArray& layers,
                       const glm::mat4& viewMatrix,
                       const glm::mat4& projMatrix) 
 {
-    if (!m_isValid)
+    if (!m_isValid || LayersChanged(layers))
     {
         BuildBatches(layers);
     }
@@ -106,6 +107,20 @@ void Renderer::Render(const LayerPtrArray& layers,
     m_lines.Render();
 }
 
+bool Renderer::LayersChanged(const LayerPtrArray& layers) const
+{
+    if (m_renderSettings.dualMode != m_builtDualMode || layers.size() != m_layerStates.size())
+        return true;
+
+    for (size_t i=0 ; i < layers.size() ; ++i)
+    {
+        if (layers[i]->GetVersion() != m_layerStates[i].version || layers[i]->IsVisible() != m_layerStates[i].visible)
+            return true;
+    }
+
+    return false;
+}
+
 void Renderer::BuildBatches(const LayerPtrArray& layers) 
 {
     std::vector<PointData> points;
@@ -113,158 +128,165 @@ void Renderer::BuildBatches(const LayerPtrArray& layers)
     std::vector<InstancedData> circles;
     std::vector<InstancedData> planes;
     std::vector<InstancedData> lines;
+
+    const bool drawDefault = (int)m_renderSettings.dualMode & (int)DualMode_Default;
+    const bool drawDual = (int)m_renderSettings.dualMode & (int)DualMode_Dual;
+
+    // The objects of each layer are bucketed by type, each bucket being gathered
+    // as the columns of its grade block and extracted at once
+    std::vector<std::vector<uint32_t>> buckets((size_t)c3ga::MvecType::NonHomogenousMultiVector + 1);
+    std::vector<uint32_t> indices;
+    std::vector<double> columns;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::mat4> matrices;
     for (const auto& layer : layers)
     {
         if (!layer->IsVisible()) {
             continue;
         }
 
-        for (const auto& obj : layer->GetObjects())
+        const size_t count = layer->GetObjectCount();
+        const auto& types = layer->GetTypes();
+        const bool normalized = layer->IsNormalized();
+
+        for (auto& bucket : buckets)
+            bucket.clear();
+        for (size_t i=0 ; i < count ; ++i)
+            buckets[(size_t)types[i]].push_back(i);
+
+        // Packed layers are read from their columns
+        PackedMvecArray packedStorage;
+        MvecArray storage;
+        const PackedMvecArray* packedObjs = layer->GetPackedObjects(packedStorage);
+        const MvecArray* objects = packedObjs ? nullptr : &layer->GetObjects(storage);
+
+        // Gathers the objects of the given types, returns their count
+        auto collect = [&](std::initializer_list<c3ga::MvecType> ofTypes) {
+            indices.clear();
+            for (const auto& type : ofTypes)
+                indices.insert(indices.end(), buckets[(size_t)type].begin(), buckets[(size_t)type].end());
+            positions.resize(indices.size());
+            matrices.resize(indices.size());
+            return indices.size();
+        };
+        // Columns of the grade block of the collected objects, read from their dual when dual is set
+        auto gather = [&](const unsigned int& grade, const bool& dual) {
+            columns.resize(c3ga::binomialArray[grade] * indices.size());
+            if (packedObjs)
+                c3ga::gatherBlocks(*packedObjs, indices.data(), 1, indices.size(), grade, dual, columns.data());
+            else
+                c3ga::gatherBlocks(objects->data(), indices.data(), 1, indices.size(), grade, dual, columns.data());
+            return columns.data();
+        };
+        auto addPoints = [&points](const std::vector<glm::vec3>& extracted) {
+            for (const glm::vec3& position : extracted)
+                points.push_back({position, {glm::abs(glm::normalize(position)), 1.0f}});
+        };
+        auto addInstances = [&matrices](std::vector<InstancedData>& batch, const glm::vec4& color) {
+            for (const glm::mat4& matrix : matrices)
+                batch.push_back({matrix, color});
+        };
+
+        // Points
+        if (drawDefault && collect({c3ga::MvecType::Point}))
+        {
+            c3ga::extractPoints(gather(1, false), indices.size(), normalized, positions.data());
+            addPoints(positions);
+        }
+
+        // Flat point
+        if (drawDefault && collect({c3ga::MvecType::FlatPoint}))
+        {
+            c3ga::extractFlatPoints(gather(2, false), indices.size(), positions.data());
+            addPoints(positions);
+        }
+        if (drawDual && collect({c3ga::MvecType::DualFlatPoint}))
+        {
+            c3ga::extractFlatPoints(gather(2, true), indices.size(), positions.data());
+            addPoints(positions);
+        }
+
+        // Spheres
+        if (drawDefault && collect({c3ga::MvecType::Sphere, c3ga::MvecType::ImaginarySphere}))
+        {
+            c3ga::extractDualSphereMatrices(gather(1, true), indices.size(), normalized, matrices.data());
+            addInstances(spheres, {0.0, 0.0, 1.0, 0.1});
+        }
+        if (drawDual && collect({c3ga::MvecType::DualSphere, c3ga::MvecType::ImaginaryDualSphere}))
+        {
+            c3ga::extractDualSphereMatrices(gather(1, false), indices.size(), normalized, matrices.data());
+            addInstances(spheres, {0.0, 0.0, 1.0, 0.1});
+        }
+
+        // Circles
+        if (collect({c3ga::MvecType::Circle,              // == DualPairPoint
+                     c3ga::MvecType::ImaginaryCircle}))   // == DualImaginaryPairPoint
         {
-            switch (c3ga::getTypeOf(obj))
+            const double* dualColumns = gather(2, true);
+            if (drawDefault)
             {
-                // Points
-                case c3ga::MvecType::Point: {
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Default)
-                    {
-                        glm::vec3 color = glm::abs(glm::normalize(glm::vec3(obj[c3ga::E1], obj[c3ga::E2], obj[c3ga::E3])));
-                        points.push_back({{obj[c3ga::E1], obj[c3ga::E2], obj[c3ga::E3]}, 
-                                          {color, 1.0f}});
-                    }
-                    break;
-                }
-
-                // Flat point
-                case c3ga::MvecType::FlatPoint: {
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Default)
-                    {
-                        c3ga::Mvec<double> flatPoint;
-                        c3ga::extractFlatPoint<double>(obj, flatPoint);
-                        glm::vec3 color = glm::abs(glm::normalize(glm::vec3(flatPoint[c3ga::E1], flatPoint[c3ga::E2], flatPoint[c3ga::E3])));
-                        points.push_back({{flatPoint[c3ga::E1], flatPoint[c3ga::E2], flatPoint[c3ga::E3]},
-                                          {color, 1.0f}});
-                    }
-                    break;
-                }
-                case c3ga::MvecType::DualFlatPoint: {
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Dual)
-                    {
-                        c3ga::Mvec<double> flatPoint;
-                        c3ga::extractFlatPoint<double>(obj.dual(), flatPoint);
-                        glm::vec3 color = glm::abs(glm::normalize(glm::vec3(flatPoint[c3ga::E1], flatPoint[c3ga::E2], flatPoint[c3ga::E3])));
-                        points.push_back({{flatPoint[c3ga::E1], flatPoint[c3ga::E2], flatPoint[c3ga::E3]},
-                                          {color, 1.0f}});
-                    }
-                    break;
-                }
-
-                // Spheres
-                case c3ga::MvecType::Sphere:
-                case c3ga::MvecType::ImaginarySphere: {
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Default)
-                    {
-                        spheres.push_back({c3ga::extractDualSphereMatrix(obj.dual()),
-                                           {0.0, 0.0, 1.0, 0.1}});
-                    }
-                    break;
-                }
-
-                case c3ga::MvecType::DualSphere:           
-                case c3ga::MvecType::ImaginaryDualSphere: {
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Dual)
-                    {
-                        spheres.push_back({c3ga::extractDualSphereMatrix(obj),
-                                           {0.0, 0.0, 1.0, 0.1}});
-                    }
-                    break;
-                }
-
-                // Circles
-                case c3ga::MvecType::Circle:             // == DualPairPoint   
-                case c3ga::MvecType::ImaginaryCircle: {  // == DualImaginaryPairPoint
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Default)
-                    {
-                        circles.push_back({c3ga::extractDualCircleMatrix(obj.dual()),
-                                           {1.0, 1.0, 0.0, 1.0}});
-                    }
-
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Dual)
-                    {
-                        c3ga::Mvec<double> pt1, pt2;
-                        c3ga::extractPairPoint(obj.dual(), pt1, pt2);
-
-                        glm::vec3 p1{pt1[c3ga::E1], pt1[c3ga::E2], pt1[c3ga::E3]};
-                        glm::vec3 p2{pt2[c3ga::E1], pt2[c3ga::E2], pt2[c3ga::E3]};
-
-                        points.push_back({p1, {glm::abs(glm::normalize(p1)), 1.0}});
-                        points.push_back({p2, {glm::abs(glm::normalize(p2)), 1.0}});
-                    }
-                    break;
-                }
-                case c3ga::MvecType::PairPoint:             // == DualCircle
-                case c3ga::MvecType::ImaginaryPairPoint: {  // == DualImaginaryCircle
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Default)
-                    {
-                        c3ga::Mvec<double> pt1, pt2;
-                        c3ga::extractPairPoint(obj, pt1, pt2);
-
-                        glm::vec3 p1{pt1[c3ga::E1], pt1[c3ga::E2], pt1[c3ga::E3]};
-                        glm::vec3 p2{pt2[c3ga::E1], pt2[c3ga::E2], pt2[c3ga::E3]};
-
-                        points.push_back({p1, {glm::abs(glm::normalize(p1)), 1.0}});
-                        points.push_back({p2, {glm::abs(glm::normalize(p2)), 1.0}});
-                    }
-
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Dual)
-                    {
-                        circles.push_back({c3ga::extractDualCircleMatrix(obj), 
-                                           {1.0, 1.0, 0.0, 1.0}});
-                    }
-
-                    break;
-                }
-
-                // Planes
-                case c3ga::MvecType::Plane: {
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Default)
-                    {
-                        glm::mat4 matrix = c3ga::extractDualPlaneMatrix(obj.dual());
-                        glm::vec3 color = glm::abs(glm::normalize(glm::vec3(matrix[1])));
-                        planes.push_back({matrix, {color, 0.1}});
-                    }
-                    break;
-                }
-                case c3ga::MvecType::DualPlane: {
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Dual)
-                    {
-                        glm::mat4 matrix = c3ga::extractDualPlaneMatrix(obj);
-                        glm::vec3 color = glm::abs(glm::normalize(glm::vec3(matrix[1])));
-                        planes.push_back({matrix, {color, 0.1}});
-                    }
-                    break;
-                }
-
-                // Lines
-                case c3ga::MvecType::Line: {
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Default)
-                    {
-                        glm::mat4 matrix = c3ga::extractDualLineMatrix(obj.dual());
-                        glm::vec3 color = glm::abs(glm::normalize(glm::vec3(matrix[2])));
-                        lines.push_back({matrix, {color, 1.0}});
-                    }
-                    break;
-                }
-                case c3ga::MvecType::DualLine: {
-                    if ((int)m_renderSettings.dualMode & (int)DualMode_Dual)
-                    {
-                        glm::mat4 matrix = c3ga::extractDualLineMatrix(obj);
-                        glm::vec3 color = glm::abs(glm::normalize(glm::vec3(matrix[2])));
-                        lines.push_back({matrix, {color, 1.0}});
-                    }
-                    break;
-                }
+                c3ga::extractDualCircleMatrices(dualColumns, indices.size(), matrices.data());
+                addInstances(circles, {1.0, 1.0, 0.0, 1.0});
+            }
+
+            if (drawDual)
+            {
+                std::vector<glm::vec3> second(indices.size());
+                c3ga::extractPairPoints(dualColumns, indices.size(), positions.data(), second.data());
+                addPoints(positions);
+                addPoints(second);
             }
         }
+        if (collect({c3ga::MvecType::PairPoint,              // == DualCircle
+                     c3ga::MvecType::ImaginaryPairPoint}))   // == DualImaginaryCircle
+        {
+            const double* objColumns = gather(2, false);
+            if (drawDefault)
+            {
+                std::vector<glm::vec3> second(indices.size());
+                c3ga::extractPairPoints(objColumns, indices.size(), positions.data(), second.data());
+                addPoints(positions);
+                addPoints(second);
+            }
+
+            if (drawDual)
+            {
+                c3ga::extractDualCircleMatrices(objColumns, indices.size(), matrices.data());
+                addInstances(circles, {1.0, 1.0, 0.0, 1.0});
+            }
+        }
+
+        // Planes
+        auto addPlanes = [&planes, &matrices]() {
+            for (const glm::mat4& matrix : matrices)
+                planes.push_back({matrix, {glm::abs(glm::normalize(glm::vec3(matrix[1]))), 0.1}});
+        };
+        if (drawDefault && collect({c3ga::MvecType::Plane}))
+        {
+            c3ga::extractDualPlaneMatrices(gather(1, true), indices.size(), matrices.data());
+            addPlanes();
+        }
+        if (drawDual && collect({c3ga::MvecType::DualPlane}))
+        {
+            c3ga::extractDualPlaneMatrices(gather(1, false), indices.size(), matrices.data());
+            addPlanes();
+        }
+
+        // Lines
+        auto addLines = [&lines, &matrices]() {
+            for (const glm::mat4& matrix : matrices)
+                lines.push_back({matrix, {glm::abs(glm::normalize(glm::vec3(matrix[2]))), 1.0}});
+        };
+        if (drawDefault && collect({c3ga::MvecType::Line}))
+        {
+            c3ga::extractDualLineMatrices(gather(2, true), indices.size(), matrices.data());
+            addLines();
+        }
+        if (drawDual && collect({c3ga::MvecType::DualLine}))
+        {
+            c3ga::extractDualLineMatrices(gather(2, false), indices.size(), matrices.data());
+            addLines();
+        }
     }
 
     m_pointCount = points.size();
@@ -302,6 +324,10 @@ void Renderer::BuildBatches(const LayerPtrArray& layers)
     vbo->SetData(lines.data(), m_lines.instanceCount * sizeof(InstancedData));
     vbo->Unbind();
 
+    m_layerStates.clear();
+    for (const auto& layer : layers)
+        m_layerStates.push_back({layer->GetVersion(), layer->IsVisible()});
+    m_builtDualMode = m_renderSettings.dualMode;
     m_isValid = true;
 }
 
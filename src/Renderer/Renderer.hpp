@@ -32,6 +32,7 @@ public:
     inline RenderSettings& GetRenderSettings() { return m_renderSettings; }
     inline const RenderSettings& GetRenderSettings() const { return m_renderSettings; }
 
+    // Forces the batches to be built again, which is otherwise only done when the layers or the dual mode changed
     void Invalidate();
     void Render(const LayerPtrArray& layers, 
                 const glm::mat4& viewMatrix,
@@ -48,6 +49,14 @@ private:
         void Render() const;
     };
 
+    // What the batches of a layer were built from, versions being unique to a layer they also tell layers apart
+    struct LayerState
+    {
+        uint64_t version;
+        bool visible;
+    };
+
+    bool LayersChanged(const LayerPtrArray& layers) const;
     void BuildBatches(const LayerPtrArray& layers);
 
     Batch m_spheres;
@@ -64,6 +73,8 @@ private:
     RenderSettings m_renderSettings;
 
     bool m_isValid = false;
+    std::vector<LayerState> m_layerStates;
+    DualMode m_builtDualMode = DualMode_Default;
 };
 
 #endif
\ No newline at end of file
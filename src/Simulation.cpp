@@ -37,6 +37,7 @@ SimulationEngine::~SimulationEngine()
 
 SimulationHandle SimulationEngine::NewSimulation()
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_lastUUID += nextUuidDistrib(uuidGenerator);
     m_simulations.insert({m_lastUUID, {}});
 
@@ -45,6 +46,7 @@ SimulationHandle SimulationEngine::NewSimulation()
 
 void SimulationEngine::RemoveSimulation(const SimulationHandle& handle)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     auto it = m_simulations.find(handle.GetId());
     if (it != m_simulations.end())
     {
@@ -55,6 +57,7 @@ void SimulationEngine::RemoveSimulation(const SimulationHandle& handle)
 
 void SimulationEngine::Update(const double &deltaTime)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     for (auto& simulation : m_simulations)
         for (auto& obj : simulation.second) 
             obj.Update(deltaTime);
@@ -62,11 +65,13 @@ void SimulationEngine::Update(const double &deltaTime)
 
 SimObjectArray& SimulationEngine::GetSimObjects(const SimulationHandle& handle)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     return m_simulations.at(handle.GetId());
 }
 
 const SimObjectArray& SimulationEngine::GetSimObjects(const SimulationHandle& handle) const
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     return m_simulations.at(handle.GetId());
 }
 
@@ -85,7 +90,7 @@ MvecArray SimulationHandle::GetObjects() const
     return result;
 }
 
-void SimulationHandle::SetObjects(const MvecArray& objects)
+void SimulationHandle::SetObjects(const MvecArray& objects, std::default_random_engine& generator)
 {
     auto& engine = SimulationEngine::Get();
     SimObjectArray& simObjects = engine.GetSimObjects(*this);
@@ -95,11 +100,13 @@ void SimulationHandle::SetObjects(const MvecArray& objects)
     for (auto& simObj : simObjects)
     {
         simObj.object = objects[i];
-        simObj.velocity = c3ga::randomVector<double>();
-        auto v1 = c3ga::randomVector<double>();
-        auto v2 = c3ga::randomVector<double>();
-        simObj.rotationPlane = v1 ^ v2;
-        simObj.rotationPlane /= simObj.rotationPlane.norm();  
+        simObj.velocity = c3ga::randomVector<double>(generator);
+        auto v1 = c3ga::randomVector<double>(generator);
+        auto v2 = c3ga::randomVector<double>(generator);
+        auto rotationPlane = v1 ^ v2;
+        simObj.rotationPlane = rotationPlane / rotationPlane.norm();
+        simObj.rotor = c3ga::Versor<double>();
+        simObj.rotorDeltaTime = 0.0;
         ++i;
     }
 }
@@ -107,10 +114,12 @@ void SimulationHandle::SetObjects(const MvecArray& objects)
 
 void SimObject::Update(const double& deltaTime)
 {
-    auto rotor = c3ga::rotor(deltaTime, rotationPlane);
+    // exp(-deltaTime / 2 * rotationPlane), whose inverse is its reverse
+    if (deltaTime != rotorDeltaTime)
+    {
+        rotor = c3ga::Versor<double>::fromBivector(rotationPlane * (-0.5 * deltaTime));
+        rotorDeltaTime = deltaTime;
+    }
     // auto translator = c3ga::translator(velocity * deltaTime);
-    object = rotor * object * rotor.inv();
-
-    // Rounding to make sure precision issues don't mess up the rest of the program
-    object.roundZero(1e-6);  
+    object = rotor.apply(object);
 }
\ No newline at end of file
@@ -6,17 +6,24 @@
 #include <c3ga/Mvec.hpp>
 #include <c3gaTools.hpp>
 #include <C3GAUtils.hpp>
+#include <C3GAVersor.hpp>
 
+#include <mutex>
+#include <random>
 #include <unordered_map>
 #include <vector>
 
 struct SimObject
 {
-    c3ga::Mvec<double> object;
-    c3ga::Mvec<double> velocity;
-    c3ga::Mvec<double> rotationPlane;
+    c3ga::DenseMvec<double> object;
+    c3ga::DenseMvec<double> velocity;
+    c3ga::DenseMvec<double> rotationPlane;
     double rotationSpeed;
 
+    // Rotor of the last frame, only rebuilt when the frame duration changes
+    c3ga::Versor<double> rotor;
+    double rotorDeltaTime = 0.0;
+
     void Update(const double& deltaTime);
 };
 
@@ -34,7 +41,8 @@ public:
     inline bool IsValid() const { return m_id != 0; }
 
     MvecArray GetObjects() const;
-    void SetObjects(const MvecArray& objects);
+    // Starts simulating the objects, their motion is drawn from generator
+    void SetObjects(const MvecArray& objects, std::default_random_engine& generator);
 
     bool operator==(const SimulationHandle& other) const { return m_id == other.m_id; }
 
@@ -46,6 +54,9 @@ private:
     uint32_t m_id;
 };
 
+// Simulations are created, removed, looked up and stepped under a lock, so that the providers
+// updated on worker threads can reach theirs. The objects of a simulation are only accessed
+// by the provider owning it.
 class SimulationEngine
 {
 public:
@@ -69,6 +80,7 @@ private:
     static SimulationEngine* s_instance;
 
     std::unordered_map<uint32_t, SimObjectArray> m_simulations;
+    mutable std::mutex m_mutex;
 
     uint32_t m_lastUUID;
 };
@@ -10,6 +10,8 @@
 #include <imgui_internal.h>
 #include <misc/cpp/imgui_stdlib.h>
 
+#include <algorithm>
+
 static const char* kEmptySelectionMessage = "Select a layer to view and edit its content.";
 
 static const c3ga::MvecType mvecTypes[] = {
@@ -49,7 +51,9 @@ bool DrawProviderComboBox(const LayerPtr& layer)
                                    "Random generator",
                                    "Subset",
                                    "Combination",
-                                   "Self combination"};
+                                   "Self combination",
+                                   "Transform",
+                                   "Pairwise distance"};
     auto createProvider = [](const uint32_t& index) -> ProviderPtr
     {
         switch (index)
@@ -64,6 +68,10 @@ bool DrawProviderComboBox(const LayerPtr& layer)
                 return std::make_shared<SelfCombination>();
             case ProviderType_Combination:
                 return std::make_shared<Combination>();
+            case ProviderType_Transform:
+                return std::make_shared<Transform>();
+            case ProviderType_PairwiseDistance:
+                return std::make_shared<PairwiseDistance>();
         }
 
         return {};
@@ -100,7 +108,7 @@ bool DrawOperatorComboBox(const LayerPtr& layer, const std::shared_ptr<OperatorB
 {
     bool somethingChanged = false;
 
-    auto indexFromOperator = [](const Operator& op)->uint32_t {
+    auto indexFromOperator = [](const OperatorConstPtr& op)->uint32_t {
         if (!op) {
             return 0;
         } else if (op == Operators::OuterProduct) {
@@ -118,10 +126,10 @@ bool DrawOperatorComboBox(const LayerPtr& layer, const std::shared_ptr<OperatorB
                              "Inner product",
                              "Geometric product",
                              "Custom operator"};
-    Operator operators[] = {nullptr,
-                            Operators::OuterProduct,
-                            Operators::InnerProduct,
-                            Operators::GeomProduct};
+    OperatorConstPtr operators[] = {nullptr,
+                                    Operators::OuterProduct,
+                                    Operators::InnerProduct,
+                                    Operators::GeomProduct};
 
     uint32_t currentIndex = indexFromOperator(provider->GetOperator());
     if (ImGui::BeginCombo((std::string("##OperatorCombo") + std::to_string(layer->GetUUID())).c_str(), 
@@ -296,6 +304,114 @@ bool DrawSelfCombinationProvider(const LayerPtr& layer)
 }
  
 
+// == Transform ==
+
+bool DrawTransformProvider(const LayerPtr& layer)
+{
+    bool somethingChanged = false;
+    auto provider = std::dynamic_pointer_cast<Transform>(layer->GetProvider());
+    std::string identifier = std::to_string(layer->GetUUID());
+
+    auto translation = provider->GetTranslation();
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Translation :");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(200);
+    if (ImGui::DragFloat3((std::string("##TransformTranslationDrag") + identifier).c_str(), translation.data(), 0.05f))
+    {
+        provider->SetTranslation(translation);
+        layer->SetDirty(DirtyBits_Provider);
+        somethingChanged = true;
+    }
+
+    auto axis = provider->GetAxis();
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Rotation axis :");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(200);
+    if (ImGui::DragFloat3((std::string("##TransformAxisDrag") + identifier).c_str(), axis.data(), 0.05f))
+    {
+        provider->SetAxis(axis);
+        layer->SetDirty(DirtyBits_Provider);
+        somethingChanged = true;
+    }
+
+    float angle = provider->GetAngle();
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Rotation angle :");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(75);
+    if (ImGui::DragFloat((std::string("##TransformAngleDrag") + identifier).c_str(), &angle, 1.0f))
+    {
+        provider->SetAngle(angle);
+        layer->SetDirty(DirtyBits_Provider);
+        somethingChanged = true;
+    }
+
+    float scale = provider->GetScale();
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Scale :");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(75);
+    if (ImGui::DragFloat((std::string("##TransformScaleDrag") + identifier).c_str(), &scale, 0.01f, 0.001f, 1000.0f))
+    {
+        provider->SetScale(scale);
+        layer->SetDirty(DirtyBits_Provider);
+        somethingChanged = true;
+    }
+
+    return somethingChanged;
+}
+ 
+
+// == Pairwise distance ==
+
+bool DrawPairwiseDistanceProvider(const LayerPtr& layer)
+{
+    bool somethingChanged = false;
+    auto provider = std::dynamic_pointer_cast<PairwiseDistance>(layer->GetProvider());
+    std::string identifier = std::to_string(layer->GetUUID());
+
+    const char* measureNames[] = {"Distance", "Power"};
+    uint32_t currentIndex = provider->GetMeasure();
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Measure :");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(150);
+    if (ImGui::BeginCombo((std::string("##PairwiseDistanceMeasureCombo") + identifier).c_str(), measureNames[currentIndex]))
+    {
+        for (size_t i=0 ; i < IM_ARRAYSIZE(measureNames) ; ++i)
+        {
+            bool selected = i == currentIndex;
+            if (ImGui::Selectable(measureNames[i], selected) && !selected) {
+                provider->SetMeasure((DistanceMeasure)i);
+                layer->SetDirty(DirtyBits_Provider);
+                somethingChanged = true;
+            }
+
+            if (selected)
+                ImGui::SetItemDefaultFocus();  
+        }
+
+        ImGui::EndCombo();
+    }
+
+    int nearestCount = provider->GetNearestCount();
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Nearest count :");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(75);
+    if (ImGui::DragInt((std::string("##PairwiseDistanceNearestDrag") + identifier).c_str(), &nearestCount, 0.05f, 0, 1000))
+    {
+        provider->SetNearestCount(nearestCount);
+        layer->SetDirty(DirtyBits_Provider);
+        somethingChanged = true;
+    }
+
+    return somethingChanged;
+}
+ 
+
 // == Sources ==
 
 bool DrawSource(const LayerPtrArray& layers, const LayerPtr& currentLayer, LayerWeakPtr& source, int index)
@@ -610,20 +726,21 @@ bool DrawDualSphereControl(const std::string& identifier, c3ga::Mvec<double>& du
 
 // == Content ==
 
-bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode) 
+// Objects are read from the editor copy of the layer objects, kept in sync with the edits
+bool DrawLayerContent(const LayerPtr& layer, MvecArray& objects, const DualMode& dualMode) 
 {
     bool somethingChanged = false;
     bool preferDual = !(dualMode & DualMode_Default);
 
-    auto& objects = layer->GetObjects();
     auto provider = layer->GetProvider();
     bool isExplicit = provider->GetType() == ProviderType_Explicit;
     bool enabled = isExplicit && !std::dynamic_pointer_cast<Explicit>(provider)->IsAnimated();
     ImGui::BeginDisabled(!enabled);
     for (size_t index=0 ; index < objects.size() ; )
     {
-        auto& obj = objects[index];
-        c3ga::MvecType objType = c3ga::getTypeOf(obj);
+        c3ga::Mvec<double> obj = objects[index].ToMvec();
+        c3ga::MvecType objType = layer->GetType(index);
+        bool objChanged = false;
         std::string objTypeName = c3ga::typeToName(objType, true, preferDual);
 
         // Type combo box
@@ -637,7 +754,7 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
                 if (ImGui::Selectable(c3ga::typeToName(mvecTypes[i], true, preferDual).c_str(), selected) && !selected) {
                     obj = convert(obj, objType, mvecTypes[i]);
                     objType = mvecTypes[i];
-                    somethingChanged = true;
+                    objChanged = true;
                 }
 
                 if (selected)
@@ -654,7 +771,7 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
         {
             case c3ga::MvecType::Point: {
                 ImGui::SameLine();
-                somethingChanged |= DrawPointControl(identifier, obj, sensitivity, availableWidth);
+                objChanged |= DrawPointControl(identifier, obj, sensitivity, availableWidth);
                 break;
             }
 
@@ -664,7 +781,7 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
                 ImGui::SameLine();
                 if (DrawDualSphereControl(identifier, dualSphere, sensitivity, availableWidth)) 
                 {
-                    somethingChanged = true;
+                    objChanged = true;
                     obj = dualSphere.dual();
                 }
                 
@@ -674,7 +791,7 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
             case c3ga::MvecType::DualSphere:
             case c3ga::MvecType::ImaginaryDualSphere: {
                 ImGui::SameLine();
-                somethingChanged |= DrawDualSphereControl(identifier, obj, sensitivity, availableWidth);
+                objChanged |= DrawDualSphereControl(identifier, obj, sensitivity, availableWidth);
                 break;
             }
         
@@ -682,7 +799,7 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
                 auto dualPlane = obj.dual();
                 ImGui::SameLine();
                 if (DrawDualPlaneControl(identifier, dualPlane, sensitivity, availableWidth)) {
-                    somethingChanged = true;
+                    objChanged = true;
                     obj = -dualPlane.dual();
                 }
 
@@ -691,7 +808,7 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
 
             case c3ga::MvecType::DualPlane: {
                 ImGui::SameLine();
-                somethingChanged |= DrawDualPlaneControl(identifier, obj, sensitivity, availableWidth);
+                objChanged |= DrawDualPlaneControl(identifier, obj, sensitivity, availableWidth);
                 break;
             }
         
@@ -699,7 +816,7 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
                 auto dualLine = obj.dual();
                 ImGui::SameLine();
                 if (DrawDualLineToLineControl(identifier, dualLine, sensitivity, availableWidth)) {
-                    somethingChanged = true;
+                    objChanged = true;
                     obj = dualLine;
                 }
 
@@ -711,7 +828,7 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
             case c3ga::MvecType::DualLine: {
                 ImGui::SameLine();
                 if (DrawDualLineToLineControl(identifier, obj, sensitivity, availableWidth)) {
-                    somethingChanged = true;
+                    objChanged = true;
                     obj = obj.dual();
                 }
 
@@ -729,7 +846,7 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
                     ImGui::SameLine();
                     if(DrawPairPointControl(identifier, pairPoint, sensitivity, availableWidth))
                     {
-                        somethingChanged = true;
+                        objChanged = true;
                         obj = pairPoint.dual();
                     }
                 }
@@ -740,7 +857,7 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
                     ImGui::SameLine();
                     if (DrawDualCircleControl(identifier, dualCircle, sensitivity, availableWidth)) 
                     {
-                        somethingChanged = true;
+                        objChanged = true;
                         obj = dualCircle.dual();
                     }
                 }
@@ -754,24 +871,33 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
                 {
                     // Display dual circle control
                     ImGui::SameLine();
-                    somethingChanged |= DrawDualCircleControl(identifier, obj, sensitivity, availableWidth);
+                    objChanged |= DrawDualCircleControl(identifier, obj, sensitivity, availableWidth);
                 }
                 else
                 {
                     // Display pair point control
                     ImGui::SameLine();
-                    somethingChanged |= DrawPairPointControl(identifier, obj, sensitivity, availableWidth);
+                    objChanged |= DrawPairPointControl(identifier, obj, sensitivity, availableWidth);
                 }
                 removeButtonOffset = ImVec2(0.0f, -9.0f);
                 break;
             }
         }
 
+        // Only the edited object is written back to the layer
+        if (objChanged)
+        {
+            objects[index] = c3ga::DenseMvec<double>(obj);
+            layer->SetObject(index, objects[index]);
+            somethingChanged = true;
+        }
+
         ImGui::SameLine(ImGui::GetWindowContentRegionMax().x - 16.0f);
         ImGui::SetCursorPos(ImGui::GetCursorPos() + removeButtonOffset);
         ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(5, 2));
         if (ImGui::Button((std::string("X##RemoveButton") + identifier).c_str()))
         {
+            layer->RemoveObject(index);
             objects.erase(objects.begin() + index);
             somethingChanged = true;
         } else {
@@ -787,7 +913,7 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
         ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(5, 1));
         if (ImGui::Button("+"))
         {
-            objects.push_back(c3ga::point(0.0, 0.0, 0.0));
+            layer->AddObject(c3ga::point(0.0, 0.0, 0.0));
             somethingChanged = true;
         }
         ImGui::PopStyleVar();
@@ -802,6 +928,42 @@ bool DrawLayerContent(const LayerPtr& layer, const DualMode& dualMode)
 
 // == Provider ==
 
+bool DrawProviderEpilogue(const LayerPtr& layer)
+{
+    bool somethingChanged = false;
+    auto provider = layer->GetProvider();
+    std::string identifier = std::to_string(layer->GetUUID());
+    uint32_t epilogue = provider->GetEpilogue();
+
+    bool normalize = epilogue & c3ga::Epilogue_Normalize;
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Normalize :");
+    ImGui::SameLine();
+    if (ImGui::Checkbox((std::string("##EpilogueNormalize") + identifier).c_str(), &normalize))
+    {
+        epilogue ^= c3ga::Epilogue_Normalize;
+        somethingChanged = true;
+    }
+
+    bool roundZero = epilogue & c3ga::Epilogue_RoundZero;
+    ImGui::SameLine();
+    ImGui::Text("Round to zero :");
+    ImGui::SameLine();
+    if (ImGui::Checkbox((std::string("##EpilogueRoundZero") + identifier).c_str(), &roundZero))
+    {
+        epilogue ^= c3ga::Epilogue_RoundZero;
+        somethingChanged = true;
+    }
+
+    if (somethingChanged)
+    {
+        provider->SetEpilogue(epilogue);
+        layer->SetDirty(DirtyBits_Provider);
+    }
+
+    return somethingChanged;
+}
+
 bool DrawProvider(const LayerPtr& layer, const LayerStackPtr& layerStack, const DualMode& dualMode) 
 {
     const auto& layers = layerStack->GetLayers();
@@ -887,8 +1049,45 @@ bool DrawProvider(const LayerPtr& layer, const LayerStackPtr& layerStack, const
 
                 break;
             }
+
+            case ProviderType_Transform: {
+                ImGui::AlignTextToFramePadding();
+                ImGui::Text("Source :");
+                ImGui::SameLine();
+
+                if (sources.empty())
+                    sources.resize(1);
+
+                sourcesChanged |= DrawSource(layers, layer, sources[0], 0);
+
+                somethingChanged |= DrawTransformProvider(layer);
+
+                break;
+            }
+
+            case ProviderType_PairwiseDistance: {
+                ImGui::AlignTextToFramePadding();
+                ImGui::Text("Source 1 :");
+                ImGui::SameLine();
+
+                if (sources.size() < 2)
+                    sources.resize(2);
+
+                sourcesChanged |= DrawSource(layers, layer, sources[0], 0);
+
+                ImGui::AlignTextToFramePadding();
+                ImGui::Text("Source 2 :");
+                ImGui::SameLine();
+                sourcesChanged |= DrawSource(layers, layer, sources[1], 1);
+
+                somethingChanged |= DrawPairwiseDistanceProvider(layer);
+
+                break;
+            }
         }
 
+        somethingChanged |= DrawProviderEpilogue(layer);
+
         if (sourcesChanged) {
             for (const auto& src : layer->GetSources())
                 layerStack->DisconnectLayers(src.lock(), layer);
@@ -904,6 +1103,79 @@ bool DrawProvider(const LayerPtr& layer, const LayerStackPtr& layerStack, const
     return somethingChanged;
 }
 
+
+// == Storage ==
+
+bool DrawLayerStorage(const LayerPtr& layer)
+{
+    bool somethingChanged = false;
+
+    const char* precisionNames[] = {"Double", "Float"};
+    std::string identifier = std::to_string(layer->GetUUID());
+    uint32_t currentIndex = layer->GetPrecision();
+
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Precision :");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(150);
+    if (ImGui::BeginCombo((std::string("##PrecisionCombo") + identifier).c_str(), precisionNames[currentIndex]))
+    {
+        for (size_t i=0 ; i < IM_ARRAYSIZE(precisionNames) ; ++i)
+        {
+            bool selected = i == currentIndex;
+            if (ImGui::Selectable(precisionNames[i], selected) && !selected) {
+                layer->SetPrecision((LayerPrecision)i);
+                somethingChanged = true;
+            }
+
+            if (selected)
+                ImGui::SetItemDefaultFocus();  
+        }
+
+        ImGui::EndCombo();
+    }
+
+    if (layer->GetPrecision() == LayerPrecision_Float)
+    {
+        bool validate = layer->GetValidatePrecision();
+        ImGui::AlignTextToFramePadding();
+        ImGui::Text("Validate types :");
+        ImGui::SameLine();
+        if (ImGui::Checkbox((std::string("##ValidatePrecision") + identifier).c_str(), &validate))
+        {
+            layer->SetValidatePrecision(validate);
+            layer->SetDirty(DirtyBits_Provider);
+            somethingChanged = true;
+        }
+    }
+
+    bool packed = layer->GetLayout() == LayerLayout_Packed;
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Packed :");
+    ImGui::SameLine();
+    if (ImGui::Checkbox((std::string("##PackedLayout") + identifier).c_str(), &packed))
+    {
+        layer->SetLayout(packed ? LayerLayout_Packed : LayerLayout_Dense);
+        somethingChanged = true;
+    }
+
+    if (packed && !layer->IsPacked() && layer->GetObjectCount())
+    {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(mixed grades, stored dense)");
+    }
+
+    int cacheSize = layer->GetCacheSize();
+    ImGui::AlignTextToFramePadding();
+    ImGui::Text("Cached results :");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(75);
+    if (ImGui::DragInt((std::string("##CacheSizeDrag") + identifier).c_str(), &cacheSize, 0.05f, 0, 16))
+        layer->SetCacheSize(std::max(cacheSize, 0));
+
+    return somethingChanged;
+}
+
     
 void DrawLockButton(const char* identifier, bool& locked)
 {
@@ -942,13 +1214,20 @@ bool ContentEditor::Draw()
         ImGui::Spacing();
         
         somethingChanged |= DrawProvider(m_layer, m_layerStack, m_dualMode);
+        somethingChanged |= DrawLayerStorage(m_layer);
 
         ImGui::Spacing();
         ImGui::Spacing();
         ImGui::Separator();
         ImGui::Spacing();
 
-        somethingChanged |= DrawLayerContent(m_layer, m_dualMode);
+        if (m_layer->GetVersion() != m_objectsVersion)
+        {
+            MvecArray storage;
+            m_objects = m_layer->GetObjects(storage);
+            m_objectsVersion = m_layer->GetVersion();
+        }
+        somethingChanged |= DrawLayerContent(m_layer, m_objects, m_dualMode);
     }
 
     m_hovered = ImGui::IsWindowHovered();
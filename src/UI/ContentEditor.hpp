@@ -34,6 +34,10 @@ private:
     LayerPtr m_layer;
     LayerStackPtr m_layerStack;
     DualMode m_dualMode;
+
+    // Objects of the current layer, only read again from the layer when its version changed
+    MvecArray m_objects;
+    uint64_t m_objectsVersion = 0;
 };
 
 #endif
\ No newline at end of file
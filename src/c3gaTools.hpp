@@ -55,7 +55,9 @@ namespace c3ga{
     }
 
 
-    static std::default_random_engine generator;
+    /// \brief one engine per thread, so that objects can be generated from several threads at once.
+    /// The seeding functions only seed the engine of the calling thread.
+    inline thread_local std::default_random_engine generator;
 
     inline void setRandomSeed(unsigned int seed){
         generator.seed(seed);
@@ -12,6 +12,7 @@
 #include "Base/Window.h"
 #include "Base/Event.h"
 #include "Base/Resolver.h"
+#include "Base/ThreadPool.h"
 
 #include <glad/glad.h>
 #include <glm/gtx/string_cast.hpp>
@@ -53,6 +54,8 @@ int main(int argc, char* argv[])
 
     // Initialize the global "managers" 
     SimulationEngine& simEngine = SimulationEngine::Init();
+    // Workers the layer stack updates independent layers on
+    ThreadPool::Init();
 
     LayerStackPtr layerStack = std::make_shared<LayerStack>();
 
@@ -66,7 +69,6 @@ int main(int argc, char* argv[])
 
     double prevTime = window.GetTime();
     double currTime, deltaTime;
-    bool somethingChanged = false;
     while (!window.ShouldClose()) {
         currTime = window.GetTime();
         deltaTime = currTime - prevTime;
@@ -80,23 +82,16 @@ int main(int argc, char* argv[])
                 if (provider->IsAnimated())
                     layer->SetDirty(DirtyBits_Provider);
 
-        // Update all the visible layers
-        for (const auto& layer : layerStack->GetLayers())
-            if (layer->IsVisible()) 
-                somethingChanged |= layer->Update();
+        // Update the visible layers and the ones they depend on, 
+        // the renderer rebuilding its batches from the layers whose version changed
+        layerStack->Evaluate();
 
         glClearColor(0.2f, 0.25f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        if (somethingChanged) {
-            renderer.Invalidate();
-        }
         renderer.Render(layerStack->GetLayers(), 
                         camera.GetViewMatrix(), 
                         camera.GetProjectionMatrix());
 
-        // Reset the invalidation variable 
-        somethingChanged = false;
-
         // // Start the Dear ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
@@ -142,7 +137,6 @@ int main(int argc, char* argv[])
                 if(ImGui::MenuItem("  New##FileMenuNew")) 
                 {
                     layerStackWid.Clear();
-                    somethingChanged = true;
                 }
 
                 ImGui::MenuItem("  Open##FileMenuOpen", "", nullptr, false);
@@ -243,17 +237,14 @@ int main(int argc, char* argv[])
                 if (ImGui::RadioButton("Default##DisplayMenuDefault", 
                                        renderSettings.dualMode == DualMode_Default)){
                     renderSettings.dualMode = DualMode_Default;
-                    somethingChanged = true;
                 }
                 if (ImGui::RadioButton("Dual##DisplayMenuDual",       
                                        renderSettings.dualMode == DualMode_Dual)){
                     renderSettings.dualMode = DualMode_Dual;
-                    somethingChanged = true;
                 }
                 if (ImGui::RadioButton("Both##DisplayMenuBoth",       
                                        renderSettings.dualMode == DualMode_Both)){
                     renderSettings.dualMode = DualMode_Both;
-                    somethingChanged = true;
                 }
                 ImGui::PopStyleVar(3);
 
@@ -272,7 +263,7 @@ int main(int argc, char* argv[])
         // ImGui::ShowDemoWindow();
 
         // Layer stack widget
-        somethingChanged |= layerStackWid.Draw();
+        layerStackWid.Draw();
         anyWindowHovered |= layerStackWid.IsHovered();
 
         // Content editors
@@ -289,7 +280,7 @@ int main(int argc, char* argv[])
             if (!editor.IsLocked())
                 editor.SetCurrentLayer(layerStackWid.GetLastSelectedLayer());
 
-            somethingChanged |= editor.Draw();
+            editor.Draw();
             anyWindowHovered |= editor.IsHovered();
 
             ++it;
@@ -305,5 +296,7 @@ int main(int argc, char* argv[])
         prevTime = currTime;
     }
 
+    ThreadPool::Shutdown();
+
     return 0;
 }
@@ -0,0 +1,88 @@
+#include "Testing.hpp"
+
+#include "LayerStack.hpp"
+#include "Simulation.hpp"
+#include "Base/ThreadPool.h"
+
+#include <vector>
+
+
+// Evaluating a stack on the thread pool must give the same objects as evaluating it serially,
+// for the providers that split their work across the pool as well as for the others.
+
+static std::vector<MvecArray> EvaluateStack(const EvaluationMode& mode)
+{
+    // Same seeds for the generators and the self combinations of both stacks
+    c3ga::setRandomSeed(11);
+
+    LayerStack stack;
+    stack.SetEvaluationMode(mode);
+    auto points = stack.NewRandomGenerator("points", c3ga::MvecType::Point, 120);
+    auto spheres = stack.NewRandomGenerator("spheres", c3ga::MvecType::DualSphere, 80);
+    auto planes = stack.NewRandomGenerator("planes", c3ga::MvecType::DualPlane, 80);
+    auto subset = stack.NewSubset("subset", points, 100);
+    subset->SetSourceDual(0, true);
+
+    stack.NewCombination("circles", spheres, planes);
+    stack.NewCombination("powers", points, spheres, Operators::InnerProduct);
+    stack.NewCombination("dualCombination", subset, planes);
+    stack.NewSelfCombination("lines", planes, 2, -1);
+    stack.NewSelfCombination("products", subset, 3, 5000, Operators::GeomProduct);
+    auto planesThroughPoints = stack.NewSelfCombination("planesThroughPoints", points, 3, 5000);
+    std::dynamic_pointer_cast<SelfCombination>(planesThroughPoints->GetProvider())->SetProductWithEi(true);
+    stack.NewTransform("transform", spheres);
+    stack.NewPairwiseDistance("distances", points, spheres);
+
+    // Animated layers draw their motion from their own generator, whatever thread runs them
+    MvecArray circles;
+    for (int i=0 ; i < 16 ; ++i)
+        circles.push_back(c3ga::DenseMvec<double>(c3ga::dualSphere<double>(i, 0.0, 0.0, 1.0) ^ c3ga::dualPlane<double>(c3ga::vector<double>(0.0, 0.0, 1.0))));
+    LayerPtrArray animated = {stack.NewLayer("animated1", circles), stack.NewLayer("animated2", circles)};
+    for (const auto& layer : animated)
+        std::dynamic_pointer_cast<Explicit>(layer->GetProvider())->SetAnimated(true);
+
+    for (const auto& layer : stack.GetLayers())
+        layer->SetVisible(true);
+    CHECK(stack.Evaluate());
+
+    // One step of the simulation, as in the main loop
+    SimulationEngine::Get().Update(0.1);
+    for (const auto& layer : animated)
+        layer->SetDirty(DirtyBits_Provider);
+    CHECK(stack.Evaluate());
+    CHECK(!AreClose(animated[0]->GetObject(0), animated[1]->GetObject(0)));
+
+    std::vector<MvecArray> result;
+    for (const auto& layer : stack.GetLayers())
+    {
+        MvecArray storage;
+        result.push_back(layer->GetObjects(storage));
+    }
+
+    return result;
+}
+
+
+int main()
+{
+    SimulationEngine::Init();
+
+    const auto serial = EvaluateStack(EvaluationMode_Serial);
+    ThreadPool::Init(4);
+    const auto parallel = EvaluateStack(EvaluationMode_Parallel);
+    ThreadPool::Shutdown();
+
+    CHECK(serial.size() == parallel.size());
+    for (size_t i=0 ; i < serial.size() && i < parallel.size() ; ++i)
+    {
+        CHECK(!serial[i].empty());
+        CHECK(serial[i].size() == parallel[i].size());
+        for (size_t n=0 ; n < serial[i].size() && n < parallel[i].size() ; ++n)
+        {
+            CHECK(serial[i][n].gradeBitmap() == parallel[i][n].gradeBitmap());
+            CHECK(AreClose(serial[i][n], parallel[i][n]));
+        }
+    }
+
+    return TEST_RESULT();
+}
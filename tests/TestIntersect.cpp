@@ -0,0 +1,178 @@
+#include "Testing.hpp"
+
+#include "C3GAIntersect.hpp"
+#include "C3GABatch.hpp"
+#include "C3GAProducts.hpp"
+
+#include <random>
+#include <vector>
+
+
+// The closed-form intersections must match the generic outer product, on the duals of the
+// operands when they are read as dual, including for degenerate pairs whose product is zero.
+
+using Mvec = c3ga::DenseMvec<double>;
+using MvecArray = std::vector<Mvec>;
+
+static std::mt19937 engine(42);
+
+static double Random(const double& min, const double& max)
+{
+    return std::uniform_real_distribution<double>(min, max)(engine);
+}
+
+static Mvec RandomDualSphere()
+{
+    return Mvec(c3ga::dualSphere<double>(Random(-1.0, 1.0), Random(-1.0, 1.0), Random(-1.0, 1.0), Random(0.1, 1.0)));
+}
+
+static Mvec RandomDualPlane()
+{
+    return Mvec(c3ga::randomVector<double>(engine) + Random(-1.0, 1.0) * c3ga::ei<double>());
+}
+
+// Objects whose duals are the given ones, the dual of the dual being the opposite
+static MvecArray Undual(MvecArray objects)
+{
+    for (auto& object : objects)
+    {
+        object.dualize();
+        object *= -1.0;
+    }
+    return objects;
+}
+
+static std::vector<c3ga::MvecType> Types(const MvecArray& objects)
+{
+    std::vector<c3ga::MvecType> types;
+    for (const auto& object : objects)
+        types.push_back(c3ga::getTypeOf(object.ToMvec()));
+    return types;
+}
+
+// Grade columns of the objects, or of their duals
+static std::vector<double> Columns(const MvecArray& objects, const unsigned int& grade, const bool& dual)
+{
+    std::vector<double> columns(c3ga::binomialArray[grade] * objects.size());
+    c3ga::gatherBlocks(objects.data(), nullptr, 0, objects.size(), grade, dual, columns.data());
+    return columns;
+}
+
+
+// Checks pairwiseIntersection() and elementwiseIntersection() against lhs ^ rhs. The operands are
+// given as they are intersected, the sources holding their inverse duals when dual is set.
+static void CheckIntersection(const MvecArray& lhs, const MvecArray& rhs, const c3ga::Intersection& expected, const bool& dual)
+{
+    const MvecArray lhsSource = dual ? Undual(lhs) : lhs;
+    const MvecArray rhsSource = dual ? Undual(rhs) : rhs;
+    const auto lhsTypes = Types(lhsSource);
+    const auto rhsTypes = Types(rhsSource);
+    const auto intersection = c3ga::getIntersection(lhsTypes.data(), lhsTypes.size(), dual,
+                                                    rhsTypes.data(), rhsTypes.size(), dual);
+    CHECK(intersection == expected);
+    if (intersection != expected)
+        return;
+
+    const unsigned int grade = c3ga::intersectionLhsGrade(intersection) + c3ga::intersectionRhsGrade(intersection);
+    const auto lhsColumns = Columns(lhsSource, c3ga::intersectionLhsGrade(intersection), dual);
+    const auto rhsColumns = Columns(rhsSource, c3ga::intersectionRhsGrade(intersection), dual);
+
+    MvecArray pairwise(lhs.size() * rhs.size());
+    c3ga::pairwiseIntersection(intersection, lhsColumns.data(), lhs.size(), rhsColumns.data(), rhs.size(), pairwise.data());
+    for (size_t i=0 ; i < lhs.size() ; ++i)
+    {
+        for (size_t j=0 ; j < rhs.size() ; ++j)
+        {
+            const Mvec& result = pairwise[i * rhs.size() + j];
+            CHECK(result.gradeBitmap() == (1u << grade));
+            CHECK(AreClose(result, lhs[i] ^ rhs[j]));
+        }
+    }
+
+    if (lhs.size() != rhs.size())
+        return;
+
+    MvecArray elementwise(lhs.size());
+    c3ga::elementwiseIntersection(intersection, lhsColumns.data(), rhsColumns.data(), lhs.size(), elementwise.data());
+    for (size_t n=0 ; n < lhs.size() ; ++n)
+        CHECK(AreClose(elementwise[n], lhs[n] ^ rhs[n]));
+}
+
+static void CheckPlanesThroughPoints(const MvecArray& a, const MvecArray& b, const MvecArray& c, const bool& dual)
+{
+    const auto aColumns = Columns(dual ? Undual(a) : a, 1, dual);
+    const auto bColumns = Columns(dual ? Undual(b) : b, 1, dual);
+    const auto cColumns = Columns(dual ? Undual(c) : c, 1, dual);
+
+    MvecArray result(a.size());
+    c3ga::planesThroughPoints(aColumns.data(), bColumns.data(), cColumns.data(), a.size(), result.data());
+    const Mvec ei(c3ga::ei<double>());
+    for (size_t n=0 ; n < a.size() ; ++n)
+    {
+        CHECK(result[n].gradeBitmap() == (1u << 4));
+        CHECK(AreClose(result[n], a[n] ^ b[n] ^ c[n] ^ ei));
+    }
+}
+
+
+int main()
+{
+    const size_t count = 64;
+    MvecArray spheres, planes, points;
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        spheres.push_back(RandomDualSphere());
+        planes.push_back(RandomDualPlane());
+        points.push_back(Mvec(c3ga::point<double>(Random(-1.0, 1.0), Random(-1.0, 1.0), Random(-1.0, 1.0))) * Random(0.5, 2.0));
+    }
+
+    // Dual circles and dual lines, intersected with vectors in both orders
+    MvecArray circles, lines;
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        circles.push_back(spheres[n] ^ planes[(n + 1) % count]);
+        lines.push_back(planes[n] ^ planes[(n + 1) % count]);
+    }
+
+    // Degenerate pairs : parallel planes and three aligned points, the spheres ^ spheres
+    // products having coincident spheres on their diagonal
+    MvecArray parallelPlanes;
+    for (const auto& plane : planes)
+        parallelPlanes.push_back(plane + Mvec(Random(-1.0, 1.0) * c3ga::ei<double>()));
+    MvecArray alignedPoints;
+    for (size_t n=0 ; n < count ; ++n)
+    {
+        const Mvec a = points[n] * (1.0 / points[n][c3ga::E0]);
+        const Mvec b = points[(n + 1) % count] * (1.0 / points[(n + 1) % count][c3ga::E0]);
+        const double t = Random(-1.0, 2.0);
+        alignedPoints.push_back(Mvec(c3ga::point<double>(a[c3ga::E1] + t * (b[c3ga::E1] - a[c3ga::E1]),
+                                                         a[c3ga::E2] + t * (b[c3ga::E2] - a[c3ga::E2]),
+                                                         a[c3ga::E3] + t * (b[c3ga::E3] - a[c3ga::E3]))));
+    }
+    MvecArray nextPoints(points.begin() + 1, points.end());
+    nextPoints.push_back(points.front());
+
+    for (const bool dual : {false, true})
+    {
+        CheckIntersection(spheres, spheres, c3ga::Intersection::VectorVector, dual);
+        CheckIntersection(spheres, planes, c3ga::Intersection::VectorVector, dual);
+        CheckIntersection(planes, planes, c3ga::Intersection::VectorVector, dual);
+        CheckIntersection(circles, planes, c3ga::Intersection::BivectorVector, dual);
+        CheckIntersection(spheres, circles, c3ga::Intersection::VectorBivector, dual);
+        CheckIntersection(lines, spheres, c3ga::Intersection::BivectorVector, dual);
+        CheckIntersection(planes, lines, c3ga::Intersection::VectorBivector, dual);
+
+        CheckIntersection(planes, parallelPlanes, c3ga::Intersection::VectorVector, dual);
+
+        CheckPlanesThroughPoints(points, nextPoints, spheres, dual);
+        CheckPlanesThroughPoints(points, nextPoints, alignedPoints, dual);
+    }
+
+    // The degenerate pairs really are zero
+    MvecArray coincident(1);
+    const auto columns = Columns(MvecArray{spheres.front()}, 1, false);
+    c3ga::elementwiseIntersection(c3ga::Intersection::VectorVector, columns.data(), columns.data(), 1, coincident.data());
+    CHECK(MaxCoefficient(coincident.front()) == 0.0);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,198 @@
+#include "Testing.hpp"
+
+#include "LayerStack.hpp"
+#include "Simulation.hpp"
+
+#include <vector>
+
+
+using Mvec = c3ga::DenseMvec<double>;
+
+static std::vector<Mvec> AllObjects(const LayerPtr& layer)
+{
+    std::vector<Mvec> result;
+    for (uint32_t i=0 ; i < layer->GetObjectCount() ; ++i)
+        result.push_back(layer->GetObject(i));
+    return result;
+}
+
+static std::vector<Mvec> FirstObjects(std::vector<Mvec> objects, const size_t& count, const bool& dual=false)
+{
+    objects.resize(count);
+    if (dual)
+        for (auto& object : objects)
+            object.dualize();
+    return objects;
+}
+
+// The layer holds the expected objects, whether they are read one by one, as an array or from its packed columns
+static bool HasObjects(const LayerPtr& layer, const std::vector<Mvec>& expected)
+{
+    MvecArray storage;
+    const MvecArray& objects = layer->GetObjects(storage);
+    if (layer->GetObjectCount() != expected.size() || objects.size() != expected.size())
+        return false;
+
+    PackedMvecArray packedStorage;
+    const auto packed = layer->GetPackedObjects(packedStorage);
+    for (uint32_t i=0 ; i < expected.size() ; ++i)
+    {
+        if (!AreClose(layer->GetObject(i), expected[i]) || !AreClose(objects[i], expected[i]))
+            return false;
+
+        if (packed)
+        {
+            Mvec object;
+            packed->get(i, object);
+            if (!AreClose(object, expected[i]))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+// == Memoization ==
+
+// Updates whose inputs did not change are skipped, and the results of previous inputs
+// are restored from the cache instead of being computed again.
+static void TestMemoization()
+{
+    LayerStack stack;
+    auto points = stack.NewRandomGenerator("points", c3ga::MvecType::Point, 50);
+    auto subset = stack.NewSubset("subset", points, 10);
+    auto pairs = stack.NewSelfCombination("pairs", subset, 2, -1);
+    auto transform = stack.NewTransform("transform", pairs);
+    for (const auto& layer : {subset, pairs, transform})
+        layer->SetCacheSize(4);
+
+    auto subsetProvider = std::dynamic_pointer_cast<Subset>(subset->GetProvider());
+    auto transformProvider = std::dynamic_pointer_cast<Transform>(transform->GetProvider());
+
+    CHECK(stack.Evaluate());
+    const uint64_t version10 = transform->GetVersion();
+    const auto objects10 = AllObjects(transform);
+    CHECK(objects10.size() == 45);
+
+    // Same inputs : nothing is recomputed
+    transform->SetDirty(DirtyBits_Provider);
+    CHECK(!stack.Evaluate());
+    CHECK(transform->GetVersion() == version10);
+
+    subsetProvider->SetCount(20);
+    subset->SetDirty(DirtyBits_Provider);
+    CHECK(stack.Evaluate());
+    CHECK(transform->GetVersion() != version10);
+    CHECK(transform->GetObjectCount() == 190);
+
+    // Back to previous inputs : the cached results and their versions come back
+    subsetProvider->SetCount(10);
+    subset->SetDirty(DirtyBits_Provider);
+    CHECK(stack.Evaluate());
+    CHECK(transform->GetVersion() == version10);
+    CHECK(HasObjects(transform, objects10));
+
+    // A provider parameter is part of the inputs as well
+    transformProvider->SetScale(2.0f);
+    transform->SetDirty(DirtyBits_Provider);
+    CHECK(stack.Evaluate());
+    CHECK(transform->GetVersion() != version10);
+    CHECK(!HasObjects(transform, objects10));
+
+    transformProvider->SetScale(1.0f);
+    transform->SetDirty(DirtyBits_Provider);
+    CHECK(stack.Evaluate());
+    CHECK(transform->GetVersion() == version10);
+    CHECK(HasObjects(transform, objects10));
+
+    // Without a cache, previous inputs are computed again
+    transform->SetCacheSize(0);
+    transformProvider->SetScale(3.0f);
+    transform->SetDirty(DirtyBits_Provider);
+    CHECK(stack.Evaluate());
+    transformProvider->SetScale(1.0f);
+    transform->SetDirty(DirtyBits_Provider);
+    CHECK(stack.Evaluate());
+    CHECK(transform->GetVersion() != version10);
+    CHECK(HasObjects(transform, objects10));
+}
+
+
+// == Subset views ==
+
+// Subsets are views over the storage of their source : they must follow the changes of
+// their source, and edits of either side must not leak into the other.
+static void TestSubsetViews()
+{
+    LayerStack stack;
+    auto spheres = stack.NewRandomGenerator("spheres", c3ga::MvecType::Sphere, 200);
+    auto subset = stack.NewSubset("subset", spheres, 50);
+    auto subsubset = stack.NewSubset("subsubset", subset, 20);
+    CHECK(stack.Evaluate());
+
+    auto source = AllObjects(spheres);
+    CHECK(subset->IsView());
+    CHECK(HasObjects(subset, FirstObjects(source, 50)));
+    CHECK(HasObjects(subsubset, FirstObjects(source, 20)));
+
+    // Storage of the source changed under the views
+    spheres->SetPrecision(LayerPrecision_Float);
+    CHECK(stack.Evaluate());
+    source = AllObjects(spheres);
+    CHECK(HasObjects(subset, FirstObjects(source, 50)));
+    CHECK(HasObjects(subsubset, FirstObjects(source, 20)));
+
+    spheres->SetPrecision(LayerPrecision_Double);
+    spheres->SetLayout(LayerLayout_Dense);
+    CHECK(stack.Evaluate());
+    source = AllObjects(spheres);
+    CHECK(HasObjects(subset, FirstObjects(source, 50)));
+    CHECK(HasObjects(subsubset, FirstObjects(source, 20)));
+
+    // Reading the source as dual
+    subset->SetSourceDual(0, true);
+    CHECK(stack.Evaluate());
+    CHECK(HasObjects(subset, FirstObjects(source, 50, true)));
+    CHECK(HasObjects(subsubset, FirstObjects(source, 20, true)));
+
+    // Editing a view only changes the view
+    const Mvec point(c3ga::point<double>(1.0, 2.0, 3.0));
+    subsubset->SetObject(0, point);
+    auto expected = FirstObjects(source, 20, true);
+    expected[0] = point;
+    CHECK(HasObjects(subsubset, expected));
+    CHECK(HasObjects(subset, FirstObjects(source, 50, true)));
+    CHECK(HasObjects(spheres, source));
+
+    // Editing the source of a view : the view keeps its objects until it is updated
+    MvecArray points;
+    for (int i=0 ; i < 8 ; ++i)
+        points.push_back(Mvec(c3ga::point<double>(i, 1.0, 2.0)));
+    auto explicitPoints = stack.NewLayer("explicitPoints", points);
+    auto explicitSubset = stack.NewSubset("explicitSubset", explicitPoints, 5);
+    CHECK(stack.Evaluate());
+    const auto before = AllObjects(explicitPoints);
+    CHECK(explicitSubset->IsView());
+    CHECK(HasObjects(explicitSubset, FirstObjects(before, 5)));
+
+    explicitPoints->SetObject(0, Mvec(c3ga::point<double>(7.0, 7.0, 7.0)));
+    CHECK(HasObjects(explicitSubset, FirstObjects(before, 5)));
+
+    explicitPoints->SetDirty(DirtyBits_Provider);
+    CHECK(stack.Evaluate());
+    const auto after = AllObjects(explicitPoints);
+    CHECK(!AreClose(after[0], before[0]));
+    CHECK(HasObjects(explicitSubset, FirstObjects(after, 5)));
+}
+
+
+int main()
+{
+    SimulationEngine::Init();
+
+    TestMemoization();
+    TestSubsetViews();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,60 @@
+#ifndef TESTING_HPP
+#define TESTING_HPP
+
+#include "DenseMvec.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+
+// Minimal checks for the test executables : a failed check is reported and counted,
+// and main returns TEST_RESULT() so that CTest sees the failures.
+inline int& TestFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                            \
+    do {                                                                            \
+        if (!(condition))                                                           \
+        {                                                                           \
+            fprintf(stderr, "%s:%d: check failed : %s\n", __FILE__, __LINE__, #condition); \
+            ++TestFailures();                                                       \
+        }                                                                           \
+    } while (false)
+
+#define TEST_RESULT() (TestFailures() == 0 ? 0 : 1)
+
+
+// Largest difference between the coefficients of two objects
+template <typename T>
+inline T MaxDifference(const c3ga::DenseMvec<T>& lhs, const c3ga::DenseMvec<T>& rhs)
+{
+    T difference = T(0);
+    for (unsigned int i=0 ; i < c3ga::denseSize ; ++i)
+        difference = std::max(difference, std::abs(lhs.data()[i] - rhs.data()[i]));
+
+    return difference;
+}
+
+// Largest coefficient of an object, to make tolerances relative
+template <typename T>
+inline T MaxCoefficient(const c3ga::DenseMvec<T>& object)
+{
+    T result = T(0);
+    for (unsigned int i=0 ; i < c3ga::denseSize ; ++i)
+        result = std::max(result, std::abs(object.data()[i]));
+
+    return result;
+}
+
+template <typename T>
+inline bool AreClose(const c3ga::DenseMvec<T>& lhs, const c3ga::DenseMvec<T>& rhs, const T& tolerance = T(1e-9))
+{
+    return MaxDifference(lhs, rhs) <= tolerance * std::max(MaxCoefficient(lhs), T(1));
+}
+
+
+#endif // TESTING_HPP
@@ -61,6 +61,9 @@ namespace c3ga{
 
     constexpr unsigned int binomialArray[6] = {1,5,10,10,5,1};  /*!< array of the (dimension + 1) first binomial coefficients */
 
+    template<typename T>
+    using KvecVector = Eigen::Matrix<T, Eigen::Dynamic, 1, Eigen::ColMajor, 10, 1>;  /*!< coefficients of a k-vector, at most 10 of them: they are stored inline rather than on the heap */
+
     constexpr unsigned int xorIndexToGrade[] = {0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5}; /*!< given a Xor index in a multivector, this array indicates the corresponding grade*/ 
 
     constexpr unsigned int xorIndexToHomogeneousIndex[] = {0,0,1,0,2,1,4,0,3,2,5,1,7,3,6,0,4,3,6,2,8,4,7,1,9,5,8,2,9,3,4,0}; /*!< given a Xor index in a multivector, this array indicates the corresponding index in the whole homogeneous vector*/
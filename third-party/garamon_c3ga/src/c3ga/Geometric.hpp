@@ -48,8 +48,8 @@ namespace c3ga {
     /// \param currentMetricCoefficient - coefficient that is used for handling the metric in the recursive formula
     /// \param depth - depth in the resulting multivector tree
     template<typename T>
-    void geoProduct(const Eigen::Matrix<T, Eigen::Dynamic, 1> &mv1,
-                    const Eigen::Matrix<T, Eigen::Dynamic, 1> &mv2,
+    void geoProduct(const KvecVector<T> &mv1,
+                    const KvecVector<T> &mv2,
                     Mvec<T> &mv3,          // multivectors to be processed
                     const unsigned int grade_mv1,
                     const unsigned int grade_mv2,
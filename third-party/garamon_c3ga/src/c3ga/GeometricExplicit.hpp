@@ -34,7 +34,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1 mv2 whose grade is 2
 	template<typename T>
-	void geometric_2_2_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void geometric_2_2_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(3) - mv1.coeff(1)*mv2.coeff(4) - mv1.coeff(2)*mv2.coeff(5) - mv1.coeff(3)*mv2.coeff(0) + mv1.coeff(4)*mv2.coeff(1) + mv1.coeff(5)*mv2.coeff(2);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(4) + mv1.coeff(1)*mv2.coeff(3) - mv1.coeff(2)*mv2.coeff(7) - mv1.coeff(3)*mv2.coeff(1) - mv1.coeff(4)*mv2.coeff(0) + mv1.coeff(7)*mv2.coeff(2);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(5) + mv1.coeff(1)*mv2.coeff(7) + mv1.coeff(2)*mv2.coeff(3) - mv1.coeff(3)*mv2.coeff(2) - mv1.coeff(5)*mv2.coeff(0) - mv1.coeff(7)*mv2.coeff(1);
@@ -54,7 +54,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1 mv2 whose grade is 3
 	template<typename T>
-	void geometric_2_3_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void geometric_2_3_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(4) + mv1.coeff(1)*mv2.coeff(2) + mv1.coeff(2)*mv2.coeff(6) - mv1.coeff(3)*mv2.coeff(0) - mv1.coeff(5)*mv2.coeff(3) + mv1.coeff(7)*mv2.coeff(1);
 		mv3.coeffRef(1) += -mv1.coeff(0)*mv2.coeff(5) - mv1.coeff(1)*mv2.coeff(6) + mv1.coeff(2)*mv2.coeff(2) - mv1.coeff(3)*mv2.coeff(1) + mv1.coeff(4)*mv2.coeff(3) - mv1.coeff(7)*mv2.coeff(0);
 		mv3.coeffRef(2) += -mv1.coeff(1)*mv2.coeff(7) - mv1.coeff(2)*mv2.coeff(8) + mv1.coeff(4)*mv2.coeff(4) + mv1.coeff(5)*mv2.coeff(5) - mv1.coeff(8)*mv2.coeff(0) - mv1.coeff(9)*mv2.coeff(1);
@@ -74,7 +74,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 4 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1 mv2 whose grade is 4
 	template<typename T>
-	void geometric_2_4_4(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void geometric_2_4_4(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(3) - mv1.coeff(1)*mv2.coeff(2) + mv1.coeff(2)*mv2.coeff(1) - mv1.coeff(3)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(2)*mv2.coeff(4) - mv1.coeff(5)*mv2.coeff(3) + mv1.coeff(7)*mv2.coeff(2) - mv1.coeff(9)*mv2.coeff(0);
 		mv3.coeffRef(2) += -mv1.coeff(1)*mv2.coeff(4) + mv1.coeff(4)*mv2.coeff(3) - mv1.coeff(7)*mv2.coeff(1) + mv1.coeff(8)*mv2.coeff(0);
@@ -89,7 +89,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1 mv2 whose grade is 3
 	template<typename T>
-	void geometric_3_2_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void geometric_3_2_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(3) - mv1.coeff(1)*mv2.coeff(7) - mv1.coeff(2)*mv2.coeff(1) + mv1.coeff(3)*mv2.coeff(5) + mv1.coeff(4)*mv2.coeff(0) - mv1.coeff(6)*mv2.coeff(2);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(7) + mv1.coeff(1)*mv2.coeff(3) - mv1.coeff(2)*mv2.coeff(2) - mv1.coeff(3)*mv2.coeff(4) + mv1.coeff(5)*mv2.coeff(0) + mv1.coeff(6)*mv2.coeff(1);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(8) + mv1.coeff(1)*mv2.coeff(9) - mv1.coeff(4)*mv2.coeff(4) - mv1.coeff(5)*mv2.coeff(5) + mv1.coeff(7)*mv2.coeff(1) + mv1.coeff(8)*mv2.coeff(2);
@@ -109,7 +109,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1 mv2 whose grade is 2
 	template<typename T>
-	void geometric_3_3_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void geometric_3_3_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(4) - mv1.coeff(1)*mv2.coeff(5) - mv1.coeff(3)*mv2.coeff(6) + mv1.coeff(4)*mv2.coeff(0) + mv1.coeff(5)*mv2.coeff(1) + mv1.coeff(6)*mv2.coeff(3);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(2) + mv1.coeff(1)*mv2.coeff(6) - mv1.coeff(2)*mv2.coeff(0) - mv1.coeff(3)*mv2.coeff(5) + mv1.coeff(5)*mv2.coeff(3) - mv1.coeff(6)*mv2.coeff(1);
 		mv3.coeffRef(2) += -mv1.coeff(0)*mv2.coeff(6) + mv1.coeff(1)*mv2.coeff(2) - mv1.coeff(2)*mv2.coeff(1) + mv1.coeff(3)*mv2.coeff(4) - mv1.coeff(4)*mv2.coeff(3) + mv1.coeff(6)*mv2.coeff(0);
@@ -129,7 +129,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1 mv2 whose grade is 4
 	template<typename T>
-	void geometric_3_3_4(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void geometric_3_3_4(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(5) + mv1.coeff(1)*mv2.coeff(4) - mv1.coeff(2)*mv2.coeff(3) - mv1.coeff(3)*mv2.coeff(2) + mv1.coeff(4)*mv2.coeff(1) - mv1.coeff(5)*mv2.coeff(0);
 		mv3.coeffRef(1) += -mv1.coeff(1)*mv2.coeff(9) + mv1.coeff(3)*mv2.coeff(8) - mv1.coeff(5)*mv2.coeff(6) - mv1.coeff(6)*mv2.coeff(5) + mv1.coeff(8)*mv2.coeff(3) - mv1.coeff(9)*mv2.coeff(1);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(9) - mv1.coeff(3)*mv2.coeff(7) + mv1.coeff(4)*mv2.coeff(6) + mv1.coeff(6)*mv2.coeff(4) - mv1.coeff(7)*mv2.coeff(3) + mv1.coeff(9)*mv2.coeff(0);
@@ -144,7 +144,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 4 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1 mv2 whose grade is 3
 	template<typename T>
-	void geometric_3_4_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void geometric_3_4_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(1)*mv2.coeff(3) + mv1.coeff(3)*mv2.coeff(2) - mv1.coeff(5)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(3) - mv1.coeff(3)*mv2.coeff(1) + mv1.coeff(4)*mv2.coeff(0);
 		mv3.coeffRef(2) += -mv1.coeff(3)*mv2.coeff(4) + mv1.coeff(6)*mv2.coeff(3) - mv1.coeff(9)*mv2.coeff(0);
@@ -164,7 +164,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1 mv2 whose grade is 4
 	template<typename T>
-	void geometric_4_2_4(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void geometric_4_2_4(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(3) - mv1.coeff(1)*mv2.coeff(2) + mv1.coeff(2)*mv2.coeff(1) - mv1.coeff(3)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(9) - mv1.coeff(2)*mv2.coeff(7) + mv1.coeff(3)*mv2.coeff(5) - mv1.coeff(4)*mv2.coeff(2);
 		mv3.coeffRef(2) += -mv1.coeff(0)*mv2.coeff(8) + mv1.coeff(1)*mv2.coeff(7) - mv1.coeff(3)*mv2.coeff(4) + mv1.coeff(4)*mv2.coeff(1);
@@ -179,7 +179,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1 mv2 whose grade is 3
 	template<typename T>
-	void geometric_4_3_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void geometric_4_3_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(5) + mv1.coeff(2)*mv2.coeff(3) - mv1.coeff(3)*mv2.coeff(1);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(4) - mv1.coeff(1)*mv2.coeff(3) + mv1.coeff(3)*mv2.coeff(0);
 		mv3.coeffRef(2) += -mv1.coeff(0)*mv2.coeff(9) + mv1.coeff(3)*mv2.coeff(6) - mv1.coeff(4)*mv2.coeff(3);
@@ -199,7 +199,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 4 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1 mv2 whose grade is 2
 	template<typename T>
-	void geometric_4_4_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void geometric_4_4_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(3) + mv1.coeff(3)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(2) - mv1.coeff(2)*mv2.coeff(0);
 		mv3.coeffRef(2) += -mv1.coeff(0)*mv2.coeff(1) + mv1.coeff(1)*mv2.coeff(0);
@@ -215,7 +215,7 @@ namespace c3ga {
 
 	
     template<typename T>
-	std::array<std::array<std::array<std::function<void(const Eigen::Matrix<T, Eigen::Dynamic, 1> & , const Eigen::Matrix<T, Eigen::Dynamic, 1> & , Eigen::Matrix<T, Eigen::Dynamic, 1>&)>, 6>, 6>, 6> geometricFunctionsContainer =
+	std::array<std::array<std::array<std::function<void(const KvecVector<T> & , const KvecVector<T> & , KvecVector<T>&)>, 6>, 6>, 6> geometricFunctionsContainer =
 	{{
 		{{
 			{{{},{},{},{},{},{}}},
@@ -45,7 +45,7 @@ namespace c3ga {
     /// \param currentMetricCoefficient - coefficient that is used for handling the metric in the recursive formula
     /// \param depth - depth in the resulting multivector tree
     template<typename T>
-    void leftContractionProductHomogeneous( const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3, // homogeneous multivectors to be processed
+    void leftContractionProductHomogeneous( const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3, // homogeneous multivectors to be processed
                                             const unsigned int grade_mv1, const unsigned int grade_mv2, const unsigned int grade_mv3,   // grade of the k-vectors
                                             unsigned int currentXorIdx1=0, unsigned int currentXorIdx2=0, unsigned int currentXorIdx3=0,             // position in the prefix tree
                                             unsigned int currentGradeMv1=0, unsigned int currentGradeMv2=0, unsigned int currentGradeMv3=0, // grade relative to the position in the prefix tree
@@ -115,7 +115,7 @@ namespace c3ga {
     /// \param currentMetricCoefficient - coefficient that is used for handling the metric in the recursive formula
     /// \param depth - depth in the resulting multivector tree
     template<typename T>
-    void rightContractionProductHomogeneous(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3, // homogeneous multivectors to be processed
+    void rightContractionProductHomogeneous(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3, // homogeneous multivectors to be processed
                                            const unsigned int grade_mv1,const unsigned int grade_mv2,const unsigned int grade_mv3,   // grade of the k-vectors
                                            unsigned int currentXorIdx1=0, unsigned int currentXorIdx2=0, unsigned int currentXorIdx3=0,             // position in the prefix tree
                                            unsigned int currentGradeMv1=0, unsigned int currentGradeMv2=0, unsigned int currentGradeMv3=0, // grade relative to the position in the prefix tree
@@ -34,7 +34,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 0 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 0
 	template<typename T>
-	void inner_0_0(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_0_0(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(0);
 	}
 
@@ -45,7 +45,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 1 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 1
 	template<typename T>
-	void inner_0_1(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_0_1(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1.coeff(0)*mv2;
 	}
 
@@ -56,7 +56,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 2
 	template<typename T>
-	void inner_0_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_0_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1.coeff(0)*mv2;
 	}
 
@@ -67,7 +67,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 3
 	template<typename T>
-	void inner_0_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_0_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1.coeff(0)*mv2;
 	}
 
@@ -78,7 +78,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 4 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 4
 	template<typename T>
-	void inner_0_4(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_0_4(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1.coeff(0)*mv2;
 	}
 
@@ -89,7 +89,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 5 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 5
 	template<typename T>
-	void inner_0_5(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_0_5(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1.coeff(0)*mv2;
 	}
 
@@ -100,7 +100,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 0 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 1
 	template<typename T>
-	void inner_1_0(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_1_0(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1*mv2.coeff(0);
 	}
 
@@ -111,7 +111,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 1 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 0
 	template<typename T>
-	void inner_1_1(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_1_1(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(4) + mv1.coeff(1)*mv2.coeff(1) + mv1.coeff(2)*mv2.coeff(2) + mv1.coeff(3)*mv2.coeff(3) - mv1.coeff(4)*mv2.coeff(0);
 	}
 
@@ -122,7 +122,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 1
 	template<typename T>
-	void inner_1_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_1_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(3) - mv1.coeff(1)*mv2.coeff(0) - mv1.coeff(2)*mv2.coeff(1) - mv1.coeff(3)*mv2.coeff(2);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(6) - mv1.coeff(2)*mv2.coeff(4) - mv1.coeff(3)*mv2.coeff(5) - mv1.coeff(4)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(8) + mv1.coeff(1)*mv2.coeff(4) - mv1.coeff(3)*mv2.coeff(7) - mv1.coeff(4)*mv2.coeff(1);
@@ -137,7 +137,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 2
 	template<typename T>
-	void inner_1_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_1_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(2) + mv1.coeff(2)*mv2.coeff(0) + mv1.coeff(3)*mv2.coeff(1);
 		mv3.coeffRef(1) += -mv1.coeff(0)*mv2.coeff(4) - mv1.coeff(1)*mv2.coeff(0) + mv1.coeff(3)*mv2.coeff(3);
 		mv3.coeffRef(2) += -mv1.coeff(0)*mv2.coeff(5) - mv1.coeff(1)*mv2.coeff(1) - mv1.coeff(2)*mv2.coeff(3);
@@ -157,7 +157,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 4 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 3
 	template<typename T>
-	void inner_1_4(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_1_4(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(1) - mv1.coeff(3)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(2) + mv1.coeff(2)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(2)*mv2.coeff(1) + mv1.coeff(3)*mv2.coeff(2);
@@ -177,7 +177,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 5 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 4
 	template<typename T>
-	void inner_1_5(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_1_5(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(0);
 		mv3.coeffRef(1) += -mv1.coeff(3)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(2)*mv2.coeff(0);
@@ -192,7 +192,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 0 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 2
 	template<typename T>
-	void inner_2_0(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_2_0(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1*mv2.coeff(0);
 	}
 
@@ -203,7 +203,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 1 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 1
 	template<typename T>
-	void inner_2_1(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_2_1(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(1) + mv1.coeff(1)*mv2.coeff(2) + mv1.coeff(2)*mv2.coeff(3) - mv1.coeff(3)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(4) + mv1.coeff(4)*mv2.coeff(2) + mv1.coeff(5)*mv2.coeff(3) - mv1.coeff(6)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(1)*mv2.coeff(4) - mv1.coeff(4)*mv2.coeff(1) + mv1.coeff(7)*mv2.coeff(3) - mv1.coeff(8)*mv2.coeff(0);
@@ -218,7 +218,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 0
 	template<typename T>
-	void inner_2_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_2_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(6) - mv1.coeff(1)*mv2.coeff(8) - mv1.coeff(2)*mv2.coeff(9) + mv1.coeff(3)*mv2.coeff(3) - mv1.coeff(4)*mv2.coeff(4) - mv1.coeff(5)*mv2.coeff(5) - mv1.coeff(6)*mv2.coeff(0) - mv1.coeff(7)*mv2.coeff(7) - mv1.coeff(8)*mv2.coeff(1) - mv1.coeff(9)*mv2.coeff(2);
 	}
 
@@ -229,7 +229,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 1
 	template<typename T>
-	void inner_2_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_2_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(2) - mv1.coeff(1)*mv2.coeff(4) - mv1.coeff(2)*mv2.coeff(5) - mv1.coeff(4)*mv2.coeff(0) - mv1.coeff(5)*mv2.coeff(1) - mv1.coeff(7)*mv2.coeff(3);
 		mv3.coeffRef(1) += -mv1.coeff(1)*mv2.coeff(7) - mv1.coeff(2)*mv2.coeff(8) - mv1.coeff(3)*mv2.coeff(2) - mv1.coeff(7)*mv2.coeff(6) + mv1.coeff(8)*mv2.coeff(0) + mv1.coeff(9)*mv2.coeff(1);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(7) - mv1.coeff(2)*mv2.coeff(9) - mv1.coeff(3)*mv2.coeff(4) + mv1.coeff(5)*mv2.coeff(6) - mv1.coeff(6)*mv2.coeff(0) + mv1.coeff(9)*mv2.coeff(3);
@@ -244,7 +244,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 4 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 2
 	template<typename T>
-	void inner_2_4(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_2_4(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(1)*mv2.coeff(1) - mv1.coeff(2)*mv2.coeff(2) - mv1.coeff(7)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(1) - mv1.coeff(2)*mv2.coeff(3) + mv1.coeff(5)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(2) + mv1.coeff(1)*mv2.coeff(3) - mv1.coeff(4)*mv2.coeff(0);
@@ -264,7 +264,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 5 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 3
 	template<typename T>
-	void inner_2_5(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_2_5(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(2)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(1)*mv2.coeff(0);
 		mv3.coeffRef(2) += -mv1.coeff(7)*mv2.coeff(0);
@@ -284,7 +284,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 0 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 3
 	template<typename T>
-	void inner_3_0(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_3_0(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1*mv2.coeff(0);
 	}
 
@@ -295,7 +295,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 1 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 2
 	template<typename T>
-	void inner_3_1(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_3_1(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(2) + mv1.coeff(1)*mv2.coeff(3) - mv1.coeff(2)*mv2.coeff(0);
 		mv3.coeffRef(1) += -mv1.coeff(0)*mv2.coeff(1) + mv1.coeff(3)*mv2.coeff(3) - mv1.coeff(4)*mv2.coeff(0);
 		mv3.coeffRef(2) += -mv1.coeff(1)*mv2.coeff(1) - mv1.coeff(3)*mv2.coeff(2) - mv1.coeff(5)*mv2.coeff(0);
@@ -315,7 +315,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 1
 	template<typename T>
-	void inner_3_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_3_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(4) - mv1.coeff(1)*mv2.coeff(5) - mv1.coeff(2)*mv2.coeff(0) - mv1.coeff(3)*mv2.coeff(7) - mv1.coeff(4)*mv2.coeff(1) - mv1.coeff(5)*mv2.coeff(2);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(8) + mv1.coeff(1)*mv2.coeff(9) - mv1.coeff(2)*mv2.coeff(3) - mv1.coeff(6)*mv2.coeff(7) - mv1.coeff(7)*mv2.coeff(1) - mv1.coeff(8)*mv2.coeff(2);
 		mv3.coeffRef(2) += -mv1.coeff(0)*mv2.coeff(6) + mv1.coeff(3)*mv2.coeff(9) - mv1.coeff(4)*mv2.coeff(3) + mv1.coeff(6)*mv2.coeff(5) + mv1.coeff(7)*mv2.coeff(0) - mv1.coeff(9)*mv2.coeff(2);
@@ -330,7 +330,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 0
 	template<typename T>
-	void inner_3_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_3_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(7) + mv1.coeff(1)*mv2.coeff(8) + mv1.coeff(2)*mv2.coeff(2) + mv1.coeff(3)*mv2.coeff(9) + mv1.coeff(4)*mv2.coeff(4) + mv1.coeff(5)*mv2.coeff(5) - mv1.coeff(6)*mv2.coeff(6) + mv1.coeff(7)*mv2.coeff(0) + mv1.coeff(8)*mv2.coeff(1) + mv1.coeff(9)*mv2.coeff(3);
 	}
 
@@ -341,7 +341,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 4 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 1
 	template<typename T>
-	void inner_3_4(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_3_4(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(1) - mv1.coeff(1)*mv2.coeff(2) - mv1.coeff(3)*mv2.coeff(3) + mv1.coeff(6)*mv2.coeff(0);
 		mv3.coeffRef(1) += -mv1.coeff(3)*mv2.coeff(4) + mv1.coeff(4)*mv2.coeff(1) + mv1.coeff(5)*mv2.coeff(2) + mv1.coeff(9)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(1)*mv2.coeff(4) - mv1.coeff(2)*mv2.coeff(1) + mv1.coeff(5)*mv2.coeff(3) - mv1.coeff(8)*mv2.coeff(0);
@@ -356,7 +356,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 5 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 2
 	template<typename T>
-	void inner_3_5(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_3_5(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(3)*mv2.coeff(0);
 		mv3.coeffRef(1) += -mv1.coeff(1)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(0);
@@ -376,7 +376,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 0 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 4
 	template<typename T>
-	void inner_4_0(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_4_0(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1*mv2.coeff(0);
 	}
 
@@ -387,7 +387,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 1 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 3
 	template<typename T>
-	void inner_4_1(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_4_1(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(3) - mv1.coeff(1)*mv2.coeff(0);
 		mv3.coeffRef(1) += -mv1.coeff(0)*mv2.coeff(2) - mv1.coeff(2)*mv2.coeff(0);
 		mv3.coeffRef(2) += -mv1.coeff(1)*mv2.coeff(2) - mv1.coeff(2)*mv2.coeff(3);
@@ -407,7 +407,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 2
 	template<typename T>
-	void inner_4_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_4_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(7) - mv1.coeff(1)*mv2.coeff(1) - mv1.coeff(2)*mv2.coeff(2);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(5) + mv1.coeff(1)*mv2.coeff(0) - mv1.coeff(3)*mv2.coeff(2);
 		mv3.coeffRef(2) += -mv1.coeff(0)*mv2.coeff(4) + mv1.coeff(2)*mv2.coeff(0) + mv1.coeff(3)*mv2.coeff(1);
@@ -427,7 +427,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 1
 	template<typename T>
-	void inner_4_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_4_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(6) + mv1.coeff(1)*mv2.coeff(0) + mv1.coeff(2)*mv2.coeff(1) + mv1.coeff(3)*mv2.coeff(3);
 		mv3.coeffRef(1) += -mv1.coeff(0)*mv2.coeff(9) - mv1.coeff(1)*mv2.coeff(4) - mv1.coeff(2)*mv2.coeff(5) + mv1.coeff(4)*mv2.coeff(3);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(8) + mv1.coeff(1)*mv2.coeff(2) - mv1.coeff(3)*mv2.coeff(5) - mv1.coeff(4)*mv2.coeff(1);
@@ -442,7 +442,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 4 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 0
 	template<typename T>
-	void inner_4_4(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_4_4(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(4) - mv1.coeff(1)*mv2.coeff(1) - mv1.coeff(2)*mv2.coeff(2) - mv1.coeff(3)*mv2.coeff(3) + mv1.coeff(4)*mv2.coeff(0);
 	}
 
@@ -453,7 +453,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 5 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 1
 	template<typename T>
-	void inner_4_5(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_4_5(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(3)*mv2.coeff(0);
 		mv3.coeffRef(2) += -mv1.coeff(2)*mv2.coeff(0);
@@ -468,7 +468,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 0 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 5
 	template<typename T>
-	void inner_5_0(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_5_0(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1*mv2.coeff(0);
 	}
 
@@ -479,7 +479,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 1 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 4
 	template<typename T>
-	void inner_5_1(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_5_1(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(0);
 		mv3.coeffRef(1) += -mv1.coeff(0)*mv2.coeff(3);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(2);
@@ -494,7 +494,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 3
 	template<typename T>
-	void inner_5_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_5_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(2);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(1);
 		mv3.coeffRef(2) += -mv1.coeff(0)*mv2.coeff(7);
@@ -514,7 +514,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 2
 	template<typename T>
-	void inner_5_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_5_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(3);
 		mv3.coeffRef(1) += -mv1.coeff(0)*mv2.coeff(1);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(0);
@@ -534,7 +534,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 4 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 1
 	template<typename T>
-	void inner_5_4(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_5_4(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(3);
 		mv3.coeffRef(2) += -mv1.coeff(0)*mv2.coeff(2);
@@ -549,14 +549,14 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 5 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1.mv2, which is also a homogeneous multivector of grade 0
 	template<typename T>
-	void inner_5_5(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void inner_5_5(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) += -mv1.coeff(0)*mv2.coeff(0);
 	}
 
 
 	
     template<typename T>
-	std::array<std::array<std::function<void(const Eigen::Matrix<T, Eigen::Dynamic, 1> & , const Eigen::Matrix<T, Eigen::Dynamic, 1> & , Eigen::Matrix<T, Eigen::Dynamic, 1>&)>, 6>, 6> innerFunctionsContainer = {{
+	std::array<std::array<std::function<void(const KvecVector<T> & , const KvecVector<T> & , KvecVector<T>&)>, 6>, 6> innerFunctionsContainer = {{
 		{{inner_0_0<T>,inner_0_1<T>,inner_0_2<T>,inner_0_3<T>,inner_0_4<T>,inner_0_5<T>}},
 		{{inner_1_0<T>,inner_1_1<T>,inner_1_2<T>,inner_1_3<T>,inner_1_4<T>,inner_1_5<T>}},
 		{{inner_2_0<T>,inner_2_1<T>,inner_2_2<T>,inner_2_3<T>,inner_2_4<T>,inner_2_5<T>}},
@@ -47,7 +47,7 @@ namespace c3ga{
     template<class T>
     struct Kvec{
 
-        Eigen::Matrix<T, Eigen::Dynamic, 1> vec;  /*!< dynamic vector of Eigen Library */
+        KvecVector<T> vec;  /*!< vector of Eigen Library, of dynamic size but stored inline */
 
         unsigned int grade; /*!< grade k of the k-vector */
 
@@ -399,7 +399,7 @@ namespace c3ga{
                         return it->vec[idxHomogeneous];
 
                     // if grade exceed, create it and inster it before the current element
-                    Kvec<T> kvec = {Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(binomialArray[grade]),grade};
+                    Kvec<T> kvec = {KvecVector<T>::Zero(binomialArray[grade]),grade};
                     auto it2 = mvData.insert(it,kvec);
                     gradeBitmap |= 1 << (grade);
                     return it2->vec[idxHomogeneous];
@@ -407,7 +407,7 @@ namespace c3ga{
             }
 
             // if the searched element should be added at the end, add it
-            Kvec<T> kvec = {Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(binomialArray[grade]),grade};
+            Kvec<T> kvec = {KvecVector<T>::Zero(binomialArray[grade]),grade};
 
             auto it2 = mvData.insert(mvData.end(),kvec);
             gradeBitmap |= 1 << (grade);
@@ -464,7 +464,7 @@ namespace c3ga{
             if(mvData.count(gd)>0)
                 return (mvData.at(gd))(idx);
 
-            mvData[gd] = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(Binomial<algebraDimension,gd>::value);
+            mvData[gd] = KvecVector<T>::Zero(Binomial<algebraDimension,gd>::value);
 
             return mvData[gd](idx);
         }
@@ -477,7 +477,7 @@ namespace c3ga{
         /// \param index : index of the parameter in the k-vector (k = grade)
         inline Mvec componentToOne(const unsigned int grade, const int index){
             Kvec<T> kvec;
-			kvec.vec=Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(binomialArray[grade]);
+			kvec.vec=KvecVector<T>::Zero(binomialArray[grade]);
 			kvec.grade=grade;
             kvec.vec[index] = T(1);
             Mvec mv1;
@@ -508,7 +508,7 @@ namespace c3ga{
 
                     // if grade exceed, create it and inster it before the current element
                     Kvec<T> kvec;
-					kvec.vec=Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(binomialArray[grade]);
+					kvec.vec=KvecVector<T>::Zero(binomialArray[grade]);
 					kvec.grade=grade;
                     auto it2 = mvData.insert(it,kvec);
                     gradeBitmap |= 1 << (grade);
@@ -518,7 +518,7 @@ namespace c3ga{
 
             // if the searched element should be added at the end, add it
             Kvec<T> kvec;
-			kvec.vec=Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(binomialArray[grade]);
+			kvec.vec=KvecVector<T>::Zero(binomialArray[grade]);
 			kvec.grade=grade;
             auto it2 = mvData.insert(mvData.end(),kvec);
             gradeBitmap |= 1 << (grade);
@@ -674,7 +674,7 @@ namespace c3ga{
             const int idx = (Binomial<algebraDimension,gd>::value-1) - computeIdxFromList(algebraDimension,gd,listIndices...);
 
             Mvec res;
-            res.mvData[gd] = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(Binomial<algebraDimension,gd>::value);
+            res.mvData[gd] = KvecVector<T>::Zero(Binomial<algebraDimension,gd>::value);
             res.mvData[gd](idx) = mvData[gd](idx);
 
             return res;
@@ -768,7 +768,7 @@ namespace c3ga{
         for(auto it=mv.mvData.begin(); it != mv.mvData.end(); ++it){
             Kvec<T> kvec;
             kvec.grade = it->grade;
-            kvec.vec = Eigen::Matrix<T, Eigen::Dynamic, 1>::Zero(binomialArray[it->grade]);
+            kvec.vec = KvecVector<T>::Zero(binomialArray[it->grade]);
             for(unsigned int i=0; i<it->vec.size(); ++i)
                 kvec.vec.coeffRef(i) = T(it->vec.coeff(i));
             mvData.push_back(kvec);
@@ -782,7 +782,7 @@ namespace c3ga{
         if(val != U(0)) {
             gradeBitmap = 1;
             Kvec<T> kvec;
-            kvec.vec =Eigen::Matrix<T, Eigen::Dynamic, 1>(1);
+            kvec.vec =KvecVector<T>(1);
             kvec.grade =0;
             mvData.push_back(kvec);
             mvData.begin()->vec.coeffRef(0) = val;
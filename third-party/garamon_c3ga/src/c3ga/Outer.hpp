@@ -42,7 +42,7 @@ namespace c3ga {
     /// \param indexLastVector_mv2 - last vector traversed in the multivector mv2
     /// \param indexLastVector_mv3 - last vector traversed in the multivector mv3
     template<typename T>
-    void outerProductHomogeneous(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3, // homogeneous multivectors to be processed
+    void outerProductHomogeneous(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3, // homogeneous multivectors to be processed
                                  const unsigned int grade_mv1,const unsigned int grade_mv2,const unsigned int grade_mv3,         // grade of the k-vectors
                                  unsigned int currentXorIdx1=0, unsigned int currentXorIdx2=0, unsigned int currentXorIdx3=0,    // position in the prefix tree
                                  unsigned int currentGradeMv1=0, unsigned int currentGradeMv2=0, unsigned int currentGradeMv3=0, // grade relative to the position in the prefix tree
@@ -105,7 +105,7 @@ namespace c3ga {
     /// \param indexLastVector_mv2 - last vector traversed in the multivector mv2
     /// \param indexLastVector_mv3 - last vector traversed in the multivector mv3
     template<typename T>
-    void outerProductPrimalDual(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3, // homogeneous multivectors to be processed
+    void outerProductPrimalDual(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3, // homogeneous multivectors to be processed
                                 const unsigned int grade_mv1, const unsigned int grade_mv2, const unsigned int grade_mv3,   // grade of the k-vectors
                                 unsigned int currentXorIdx1=0, unsigned int currentXorIdx2=0, unsigned int currentXorIdx3=(1<<algebraDimension)-1,  // position in the prefix tree
                                 unsigned int currentGradeMv1=0, unsigned int currentGradeMv2=0, unsigned int currentGradeMv3=0, // grade relative to the position in the prefix tree
@@ -175,7 +175,7 @@ namespace c3ga {
     /// \param indexLastVector_mv2 - last vector traversed in the multivector mv2
     /// \param indexLastVector_mv3 - last vector traversed in the multivector mv3
     template<typename T>
-    void outerProductDualPrimal(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3, // homogeneous multivectors to be processed
+    void outerProductDualPrimal(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3, // homogeneous multivectors to be processed
                                 const unsigned int grade_mv1, const unsigned int grade_mv2, const unsigned int grade_mv3,   // grade of the k-vectors
                                 unsigned int currentXorIdx1=0, unsigned int currentXorIdx2=0, unsigned int currentXorIdx3=(1<<algebraDimension)-1,             // position in the prefix tree
                                 unsigned int currentGradeMv1=0, unsigned int currentGradeMv2=0, unsigned int currentGradeMv3=0, // grade relative to the position in the prefix tree
@@ -242,7 +242,7 @@ namespace c3ga {
     /// \param indexLastVector_mv2 - last vector traversed in the multivector mv2
     /// \param indexLastVector_mv3 - last vector traversed in the multivector mv3
     template<typename T>
-    void outerProductDualDual(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3, // homogeneous multivectors to be processed
+    void outerProductDualDual(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3, // homogeneous multivectors to be processed
                                 const unsigned int grade_mv1, const unsigned int grade_mv2, const unsigned int grade_mv3,   // grade of the k-vectors
                                 unsigned int currentXorIdx1=(1<<algebraDimension)-1, unsigned int currentXorIdx2=(1<<algebraDimension)-1, unsigned int currentXorIdx3=(1<<algebraDimension)-1,             // position in the prefix tree
                                 unsigned int currentGradeMv1=0, unsigned int currentGradeMv2=0, unsigned int currentGradeMv3=0, // grade relative to the position in the prefix tree
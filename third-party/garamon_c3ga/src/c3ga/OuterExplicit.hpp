@@ -34,7 +34,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 0 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 0
 	template<typename T>
-	void outer_0_0(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_0_0(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(0);
 	}
 
@@ -45,7 +45,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 1 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 1
 	template<typename T>
-	void outer_0_1(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_0_1(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1.coeff(0)*mv2;
 	}
 
@@ -56,7 +56,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 2
 	template<typename T>
-	void outer_0_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_0_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1.coeff(0)*mv2;
 	}
 
@@ -67,7 +67,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 3
 	template<typename T>
-	void outer_0_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_0_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1.coeff(0)*mv2;
 	}
 
@@ -78,7 +78,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 4 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 4
 	template<typename T>
-	void outer_0_4(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_0_4(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1.coeff(0)*mv2;
 	}
 
@@ -89,7 +89,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 5 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 5
 	template<typename T>
-	void outer_0_5(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_0_5(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1.coeff(0)*mv2;
 	}
 
@@ -100,7 +100,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 0 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 1
 	template<typename T>
-	void outer_1_0(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_1_0(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1*mv2.coeff(0);
 	}
 
@@ -111,7 +111,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 1 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 2
 	template<typename T>
-	void outer_1_1(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_1_1(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(1) - mv1.coeff(1)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(2) - mv1.coeff(2)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(3) - mv1.coeff(3)*mv2.coeff(0);
@@ -131,7 +131,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 3
 	template<typename T>
-	void outer_1_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_1_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(4) - mv1.coeff(1)*mv2.coeff(1) + mv1.coeff(2)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(5) - mv1.coeff(1)*mv2.coeff(2) + mv1.coeff(3)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(6) - mv1.coeff(1)*mv2.coeff(3) + mv1.coeff(4)*mv2.coeff(0);
@@ -151,7 +151,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 4
 	template<typename T>
-	void outer_1_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_1_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(6) - mv1.coeff(1)*mv2.coeff(3) + mv1.coeff(2)*mv2.coeff(1) - mv1.coeff(3)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(7) - mv1.coeff(1)*mv2.coeff(4) + mv1.coeff(2)*mv2.coeff(2) - mv1.coeff(4)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(8) - mv1.coeff(1)*mv2.coeff(5) + mv1.coeff(3)*mv2.coeff(2) - mv1.coeff(4)*mv2.coeff(1);
@@ -166,7 +166,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 4 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 5
 	template<typename T>
-	void outer_1_4(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_1_4(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(4) - mv1.coeff(1)*mv2.coeff(3) + mv1.coeff(2)*mv2.coeff(2) - mv1.coeff(3)*mv2.coeff(1) + mv1.coeff(4)*mv2.coeff(0);
 	}
 
@@ -177,7 +177,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 0 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 2
 	template<typename T>
-	void outer_2_0(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_2_0(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1*mv2.coeff(0);
 	}
 
@@ -188,7 +188,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 1 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 3
 	template<typename T>
-	void outer_2_1(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_2_1(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(2) - mv1.coeff(1)*mv2.coeff(1) + mv1.coeff(4)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(3) - mv1.coeff(2)*mv2.coeff(1) + mv1.coeff(5)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(4) - mv1.coeff(3)*mv2.coeff(1) + mv1.coeff(6)*mv2.coeff(0);
@@ -208,7 +208,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 4
 	template<typename T>
-	void outer_2_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_2_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(7) - mv1.coeff(1)*mv2.coeff(5) + mv1.coeff(2)*mv2.coeff(4) + mv1.coeff(4)*mv2.coeff(2) - mv1.coeff(5)*mv2.coeff(1) + mv1.coeff(7)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(8) - mv1.coeff(1)*mv2.coeff(6) + mv1.coeff(3)*mv2.coeff(4) + mv1.coeff(4)*mv2.coeff(3) - mv1.coeff(6)*mv2.coeff(1) + mv1.coeff(8)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(0)*mv2.coeff(9) - mv1.coeff(2)*mv2.coeff(6) + mv1.coeff(3)*mv2.coeff(5) + mv1.coeff(5)*mv2.coeff(3) - mv1.coeff(6)*mv2.coeff(2) + mv1.coeff(9)*mv2.coeff(0);
@@ -223,7 +223,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 3 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 5
 	template<typename T>
-	void outer_2_3(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_2_3(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(9) - mv1.coeff(1)*mv2.coeff(8) + mv1.coeff(2)*mv2.coeff(7) - mv1.coeff(3)*mv2.coeff(6) + mv1.coeff(4)*mv2.coeff(5) - mv1.coeff(5)*mv2.coeff(4) + mv1.coeff(6)*mv2.coeff(3) + mv1.coeff(7)*mv2.coeff(2) - mv1.coeff(8)*mv2.coeff(1) + mv1.coeff(9)*mv2.coeff(0);
 	}
 
@@ -234,7 +234,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 0 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 3
 	template<typename T>
-	void outer_3_0(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_3_0(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1*mv2.coeff(0);
 	}
 
@@ -245,7 +245,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 1 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 4
 	template<typename T>
-	void outer_3_1(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_3_1(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(3) - mv1.coeff(1)*mv2.coeff(2) + mv1.coeff(3)*mv2.coeff(1) - mv1.coeff(6)*mv2.coeff(0);
 		mv3.coeffRef(1) +=  mv1.coeff(0)*mv2.coeff(4) - mv1.coeff(2)*mv2.coeff(2) + mv1.coeff(4)*mv2.coeff(1) - mv1.coeff(7)*mv2.coeff(0);
 		mv3.coeffRef(2) +=  mv1.coeff(1)*mv2.coeff(4) - mv1.coeff(2)*mv2.coeff(3) + mv1.coeff(5)*mv2.coeff(1) - mv1.coeff(8)*mv2.coeff(0);
@@ -260,7 +260,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 2 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 5
 	template<typename T>
-	void outer_3_2(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_3_2(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(9) - mv1.coeff(1)*mv2.coeff(8) + mv1.coeff(2)*mv2.coeff(7) + mv1.coeff(3)*mv2.coeff(6) - mv1.coeff(4)*mv2.coeff(5) + mv1.coeff(5)*mv2.coeff(4) - mv1.coeff(6)*mv2.coeff(3) + mv1.coeff(7)*mv2.coeff(2) - mv1.coeff(8)*mv2.coeff(1) + mv1.coeff(9)*mv2.coeff(0);
 	}
 
@@ -271,7 +271,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 0 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 4
 	template<typename T>
-	void outer_4_0(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_4_0(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1*mv2.coeff(0);
 	}
 
@@ -282,7 +282,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 1 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 5
 	template<typename T>
-	void outer_4_1(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_4_1(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3.coeffRef(0) +=  mv1.coeff(0)*mv2.coeff(4) - mv1.coeff(1)*mv2.coeff(3) + mv1.coeff(2)*mv2.coeff(2) - mv1.coeff(3)*mv2.coeff(1) + mv1.coeff(4)*mv2.coeff(0);
 	}
 
@@ -293,7 +293,7 @@ namespace c3ga {
 	/// \param mv2 - the second homogeneous multivector of grade 0 represented as a Eigen::VectorXd
 	/// \param mv3 - the result of mv1^mv2, which is also a homogeneous multivector of grade 5
 	template<typename T>
-	void outer_5_0(const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv1, const Eigen::Matrix<T, Eigen::Dynamic, 1>& mv2, Eigen::Matrix<T, Eigen::Dynamic, 1>& mv3){
+	void outer_5_0(const KvecVector<T>& mv1, const KvecVector<T>& mv2, KvecVector<T>& mv3){
 		mv3 += mv1*mv2.coeff(0);
 	}
 
@@ -301,7 +301,7 @@ namespace c3ga {
 	
 
     template<typename T>
-	std::array<std::array<std::function<void(const Eigen::Matrix<T, Eigen::Dynamic, 1> & , const Eigen::Matrix<T, Eigen::Dynamic, 1> & , Eigen::Matrix<T, Eigen::Dynamic, 1>&)>, 6>, 6> outerFunctionsContainer = {{
+	std::array<std::array<std::function<void(const KvecVector<T> & , const KvecVector<T> & , KvecVector<T>&)>, 6>, 6> outerFunctionsContainer = {{
 		{{outer_0_0<T>,outer_0_1<T>,outer_0_2<T>,outer_0_3<T>,outer_0_4<T>,outer_0_5<T>}},
 		{{outer_1_0<T>,outer_1_1<T>,outer_1_2<T>,outer_1_3<T>,outer_1_4<T>,{}}},
 		{{outer_2_0<T>,outer_2_1<T>,outer_2_2<T>,outer_2_3<T>,{},{}}},